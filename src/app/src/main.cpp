@@ -1,4 +1,6 @@
 
+#include <map>
+
 #include "cxxopts/cxxopts.hpp"
 
 #include "partition.hpp"
@@ -10,9 +12,42 @@
 #include "plotter.hpp"
 
 
-std::vector<std::filesystem::path>
+struct ArgsType
+{
+    std::vector<std::filesystem::path> paths;
+
+    bool adaptive  {};
+    bool congruent {};
+    bool lazy      {};
+    bool compact   {};
+    bool renumber  {};
+    bool fastFwd   {};
+    bool visSets   {};
+    bool flow      {};
+    bool hierarchy {};
+
+    /* look-ahead of the agents, in steps */
+    CrdType horizon {};
+
+    /* congestion cost of the routes, per agent in a cell */
+    CrdType crowd {};
+
+    /* the step the exits close at, to reopen as many steps later (0: never) */
+    IdxType block {};
+
+    std::optional<unsigned> seed;
+
+    /* reference trajectories (of another build, eg.) */
+    std::filesystem::path refPath;
+};
+
+ArgsType
 argParser(int argc, char ** argv);
 
+std::optional<std::string>
+compareTrajectories(std::filesystem::path const & otptPath,
+                    std::filesystem::path const & refPath );
+
 
 /** measures durations in seconds of type double */
 class Timer
@@ -50,9 +85,10 @@ public:
               IdxType            cIdx,
               smr::Point         pos,
               Geometry   const & geometry,
-              Router     const & router  )
+              Router     const & router  ,
+              bool               fFlg    )
         
-        : Actuator { nIdx, cIdx, pos, geometry, router }
+        : Actuator { nIdx, cIdx, pos, geometry, router, fFlg }
         {}
 };
 
@@ -63,7 +99,7 @@ int main(int argc, char ** argv)
     
     std::cout << std::endl;  /* good measure */
 
-    auto argVec { argParser(argc, argv) };
+    auto [argVec, adaptive, congruent, lazy, compact, renumber, fastFwd, visSets, flow, hierarchy, horizon, crowd, block, seedOpt, refPath] { argParser(argc, argv) };
 
     auto geomPath { argVec[0] };
     auto otptPath { argVec[1] };
@@ -76,8 +112,9 @@ int main(int argc, char ** argv)
     else
         ptp = false;
 
-    Mesher   mesher   { 4      };
-    Geometry geometry { mesher };
+    Mesher   mesher   { adaptive ? Mesher { 4, Mesher::RFN } : Mesher { 4 } };
+    /* local routes are formed as cells are parsed, unless lazy */
+    Geometry geometry { mesher, true, congruent, not lazy, renumber, visSets };
     
     timer.now();
     Partition partition {                               };
@@ -99,12 +136,23 @@ int main(int argc, char ** argv)
      */
     timer.now();
     Finder finder { geometry, 2, 4   };
-    Router router { geometry, finder };
+    Router router { lazy ? Router { geometry, finder, true, hierarchy                   } :
+                           Router { geometry, finder, geometry.releaseMCSs(), hierarchy } };
 
     std::cout << fmt::format("Router: {:7.3f} secs", timer.duration()) << std::endl;
 
+    if (compact)
+    {
+        auto const bytes { router.footprint() };
+
+        if (auto const routerError { router.compact() })
+            throw std::logic_error(routerError.value());
+
+        std::cout << fmt::format("Router: {} -> {} bytes", bytes, router.footprint()) << std::endl;
+    }
+
     /* randomly distribute the agents on midpoints of nonsolid lines */
-    auto const seed { std::time(nullptr) % (1 << 24) };
+    auto const seed { seedOpt.value_or(std::time(nullptr) % (1 << 24)) };
     std::srand(seed);
     std::cout << fmt::format("Seed #:   {}", seed) << std::endl;
 
@@ -119,9 +167,17 @@ int main(int argc, char ** argv)
     
     auto cnt { geometry.linesPerCell() };
 
+    // cells are drawn in nominal order, which renumbering leaves alone,
+    // so that a seed places agents alike with '-n', for '-r' to compare
+    auto const & cMapR { geometry.getCMapR() };
+
+    std::vector<IdxType> cIdxz (cnt.size());
+    std::iota(cIdxz.begin(), cIdxz.end(), IdxType {});
+    std::sort(cIdxz.begin(), cIdxz.end(), [& cMapR] (IdxType a, IdxType b) { return cMapR.at(a) < cMapR.at(b); });
+
     for (IdxType i {}; i < agnts; i++)
     {
-        IdxType const cIdx { static_cast<IdxType>(randr(cnt.size())) };
+        IdxType const cIdx { cIdxz[randr(cnt.size())]                };
         IdxType const sIdx { static_cast<IdxType>(randr(cnt[cIdx] )) };
 
         /* test for well-paddedness and dummy cells */
@@ -132,14 +188,58 @@ int main(int argc, char ** argv)
             continue;
         }
 
-        actr.push_back(std::make_unique<ActuatorD>( i, cIdx, pos, geometry, router ));
+        if (flow)
+            actr.push_back(std::make_unique<FlowActuator>( i, cIdx, pos, geometry, router ));
+        else
+            actr.push_back(std::make_unique<ActuatorD>( i, cIdx, pos, geometry, router, fastFwd ));
+    }
+
+    // closes the exits mid-run, stranding the agents left, and reopens
+    // them later; the router reroutes in place, between steps
+    Simmer::HookType hook;
+    if (block)
+    {
+        std::vector<DuoType> exits;
+
+        auto const & nosoz { geometry.getNosoz() };
+        for (IdxType c {}; c < nosoz.size(); c++)
+            for (IdxType s {}; s < nosoz[c].size(); s++)
+                if (geometry.isExit(c, s))
+                    exits.push_back({ c, s });
+
+        hook = [& router, exits, block] (IdxType stp)
+        {
+            // the step loop is running: a failed block is reported, and
+            // ends the intervention rather than unwinding through it
+            if ((stp == block) or (stp == 2 * block))
+                if (auto const routerError { router.block(exits, stp == block) })
+                {
+                    std::cout << routerError.value() << std::endl;
+                    return false;
+                }
+
+            return stp < 2 * block;
+        };
     }
 
     /* commence the simulation */
     timer.now();
-    Simmer simmer { geometry, router, actr, 7 };
+    Simmer simmer { geometry, router, actr, 7, horizon, crowd, hook };
     std::cout << fmt::format("Simmer: {:7.3f} secs", timer.duration()) << std::endl;
 
+    IdxType hits   {};
+    IdxType misses {};
+    IdxType ffwds  {};
+    for (auto const & a : actr)
+    {
+        auto const [h, m, f] { a->getNaviCnts() };
+
+        hits   += h;
+        misses += m;
+        ffwds  += f;
+    }
+    std::cout << fmt::format("Navi:     {} revalidated, {} found afresh, {} fast-forwarded", hits, misses, ffwds) << std::endl;
+
     /*
      * primary output,
      * an XML file:
@@ -149,9 +249,16 @@ int main(int argc, char ** argv)
      * (child)^3 nodes : position in cell
      */
     timer.now();
-    Writer writer { geometry, actr, otptPath };
+    {
+        Writer writer { geometry, actr, otptPath };
+    }
     std::cout << fmt::format("Writer: {:7.3f} secs", timer.duration()) << std::endl;
 
+    /* validation against the trajectories of another build */
+    if (not refPath.empty())
+        if (auto const compareError { compareTrajectories(otptPath, refPath) })
+            throw std::logic_error(compareError.value());
+
     /* secondary output */
     if (ptp)
     {
@@ -179,15 +286,33 @@ int main(int argc, char ** argv)
 }
 
 
-std::vector<std::filesystem::path>
+ArgsType
 argParser(int argc, char ** argv)
 {
     cxxopts::Options options { "simmerApp", "Console access to the Simmer library" };
 
     options.add_options()
-        ("g,geometry", "Geometry specification file", cxxopts::value<std::string>())
-        ("o,output"  , "Output trajectory file"     , cxxopts::value<std::string>())
-        ("p,plot"    , "Plot file"                  , cxxopts::value<std::string>())
+        ("g,geometry" , "Geometry specification file", cxxopts::value<std::string>())
+        ("o,output"   , "Output trajectory file"     , cxxopts::value<std::string>())
+        ("p,plot"     , "Plot file"                  , cxxopts::value<std::string>())
+        ("a,adaptive" , "Adaptive mesh refinement"                                     )
+        ("c,congruent", "Share meshes and local routes among congruent cells"          )
+        ("l,lazy"     , "Form local routes of cells on first use"                      )
+        ("k,compact"  , "Keep only the query tables of the router"                     )
+        ("n,renumber" , "Renumber cells for locality"                                  )
+        ("f,fast"     , "Fast-forward agents with the exit in sight"                   )
+        ("w,wallsets" , "Precompute the walls in sight of each line"                   )
+        ("m,flow"     , "Steer agents down the mesh flow field, with no sight lines"   )
+        ("i,hierarchy", "Index the global routes with a contraction hierarchy"         )
+        ("z,horizon"  , "Look-ahead of the agents, in steps (grows as they leave)"
+                                                            , cxxopts::value<double>())
+        ("x,crowd"    , "Reroute around crowds, at this route length per agent in a cell"
+                                                            , cxxopts::value<double>())
+        ("b,block"    , "Close the exits at this step, and reopen them as many steps later"
+                                                            , cxxopts::value<unsigned>())
+        ("s,seed"     , "Seed of the agent distribution"   , cxxopts::value<unsigned>())
+        ("r,reference", "Reference trajectory file to compare against"
+                                                            , cxxopts::value<std::string>())
         ;
     
     auto result { options.parse(argc, argv) };
@@ -250,7 +375,135 @@ argParser(int argc, char ** argv)
         argVec.push_back(plotPath);
     }
     
-    return argVec;
+    CrdType horizon {};
+    if (result.count("z"))
+        horizon = result["z"].as<double>();
+
+    CrdType crowd {};
+    if (result.count("x"))
+        crowd = result["x"].as<double>();
+
+    IdxType block {};
+    if (result.count("b"))
+    {
+        /* the compact router drops the graph a block reroutes over */
+        if (result.count("k"))
+        {
+            std::cout << "Blocking exits requires the full router" << std::endl;
+            exit(1);
+        }
+
+        block = result["b"].as<unsigned>();
+    }
+
+    std::optional<unsigned> seed;
+    if (result.count("s"))
+        seed = result["s"].as<unsigned>();
+
+    std::filesystem::path refPath {};
+    if (result.count("r"))
+    {
+        refPath = result["r"].as<std::string>();
+
+        if (not static_cast<std::filesystem::directory_entry>(refPath).is_regular_file())
+        {
+            std::cout << "Invalid reference file" << std::endl;
+            exit(1);
+        }
+    }
+    
+    return { argVec, result.count("a") > 0, result.count("c") > 0, result.count("l") > 0,
+             result.count("k") > 0, result.count("n") > 0, result.count("f") > 0, result.count("w") > 0,
+             result.count("m") > 0, result.count("i") > 0, horizon, crowd, block, seed, refPath };
+}
+
+
+// compares trajectories step by step: agents that pass through the same
+// cells, and the largest deviation of positions at the steps they share
+// a cell; the same seed is expected on both sides
+std::optional<std::string>
+compareTrajectories(std::filesystem::path const & otptPath,
+                    std::filesystem::path const & refPath )
+{
+    /* (cell, position) per step of each agent */
+    using StepType = std::tuple<IdxType, double, double>;
+    using TrajType = std::map<IdxType, std::vector<StepType>>;
+
+    auto const load
+    {
+        [] (std::filesystem::path const & path, TrajType & trajs) -> std::optional<std::string>
+        {
+            pugi::xml_document doc;
+            if (not doc.load_file(path.string().c_str()))
+                return fmt::format("Could not load the trajectory file {}", path.string());
+
+            for (auto const & xAgent : doc.child("agents").children("agent"))
+            {
+                auto & traj { trajs[xAgent.attribute("idx").as_ullong()] };
+
+                for (auto const & xCell : xAgent.children("cell"))
+                    for (auto const & xPoint : xCell.children("point"))
+                        traj.emplace_back(xCell .attribute("idx").as_ullong(),
+                                          xPoint.attribute("x"  ).as_double(),
+                                          xPoint.attribute("y"  ).as_double());
+            }
+
+            return {};
+        }
+    };
+
+    TrajType trajsO;
+    TrajType trajsR;
+
+    if (auto const err { load(otptPath, trajsO) })
+        return err;
+
+    if (auto const err { load(refPath , trajsR) })
+        return err;
+
+    if (trajsO.size() != trajsR.size())
+        return fmt::format("Agent counts differ ({} vs {} in the reference)", trajsO.size(), trajsR.size());
+
+    IdxType same  {};
+    IdxType stpsO {};
+    IdxType stpsR {};
+    double  dev   {};
+
+    for (auto const & [idx, trajO] : trajsO)
+    {
+        if (not trajsR.contains(idx))
+            return fmt::format("Agent {} is missing from the reference", idx);
+
+        auto const & trajR { trajsR.at(idx) };
+
+        stpsO += trajO.size();
+        stpsR += trajR.size();
+
+        bool cells { trajO.size() == trajR.size() };
+
+        for (IdxType i {}; i < std::min(trajO.size(), trajR.size()); i++)
+        {
+            auto const & [cIdxO, xO, yO] { trajO[i] };
+            auto const & [cIdxR, xR, yR] { trajR[i] };
+
+            if (cIdxO != cIdxR)
+            {
+                cells = false;
+                continue;
+            }
+
+            dev = std::max(dev, std::hypot(xO - xR, yO - yR));
+        }
+
+        same += cells;
+    }
+
+    std::cout << fmt::format("Validate: {} of {} agents pass through the same cells", same, trajsO.size())
+              << std::endl;
+    std::cout << fmt::format("Validate: {} vs {} steps, max deviation {:.2f}", stpsO, stpsR, dev)
+              << std::endl;
+
+    return {};
 }
 
 
@@ -520,7 +520,9 @@ namespace CDT
 namespace detail
 {
 
-static mt19937 randGenerator(9001);
+// one generator per thread: triangulations may run concurrently, and
+// each reseeds the generator for deterministic vertex insertion order
+static thread_local mt19937 randGenerator(9001);
 
 template <class RandomIt>
 void random_shuffle(RandomIt first, RandomIt last)
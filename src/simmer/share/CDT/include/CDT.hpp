@@ -492,6 +492,9 @@ bool Triangulation<T, TNearPointLocator>::isFlipNeeded(
     const V2d<T>& v1 = vertices[iV1];
     const V2d<T>& v2 = vertices[iV2];
     const V2d<T>& v3 = vertices[iV3];
+    // flip not needed if the original edge is fixed
+    if(fixedEdges.count(Edge(iV1, iV3)))
+        return false;
     if(m_superGeomType == SuperGeometryType::SuperTriangle)
     {
         // If flip-candidate edge touches super-triangle in-circumference test
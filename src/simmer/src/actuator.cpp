@@ -30,14 +30,16 @@ Actuator::Actuator(IdxType            nIdx    ,
                    IdxType            cIdx    ,
                    smr::Point         pos     ,
                    Geometry   const & geometry,
-                   Router     const & router  )
+                   Router     const & router  ,
+                   bool               fFlg    )
 
     : idx       { gIdx++   },
       nIdx      { nIdx     },
       cIdx      { cIdx     },
       pos       { pos      },
       geometry  { geometry },
-      router    { router   }
+      router    { router   },
+      fFlg      { fFlg     }
 {
     path.emplace_back(CellPathType { cIdx, {} });
     path.back().second.emplace_back(pos);
@@ -47,27 +49,93 @@ Actuator::Actuator(IdxType            nIdx    ,
 void
 Actuator::operator()(std::queue<IdxType>       & que ,
                      std::mutex                & queM,
-                     ViewType            const   iVue,
-                     ViewType                    oVue,
+                     ViewType            const & iVue,
+                     ViewType                  & oVue,
                      std::mutex                & vueM)
 {
+    // the others, as of the last step: 'iVue' is only written between
+    // steps, so it is read in place, with no lock and no copy
     [[ maybe_unused ]]
     auto const nbrs
     {
-        [this, & iVue, & vueM]
+        [this, & iVue] () -> std::span<smr::Line const>
         {
-            std::unique_lock const lock { vueM };
-            
-            if (iVue.contains(cIdx))
-                       return iVue.at(cIdx);
-            return std::vector<smr::Line> {};
+            if (auto const it { iVue.find(cIdx) }; it != iVue.end())
+                return it->second;
+            return {};
         }()
     };
 
-    auto const [lines, cells] { router.findVisible(cIdx, pos, IdxTypeMax) };
+    /* buffers of the router's queries, warm after the first few steps */
+    thread_local Router::ScratchType scr;
+
+    strd = false;
+
+    /* the routes held are stale once the router reroutes */
+    [[ unlikely ]]
+    if (rts != router.reroutes())
+    {
+        rts = router.reroutes();
+
+        trgt.reset();
+        exitCells.clear();
+    }
+
+    std::optional<NaviView> navi;
+
+    if (not exitCells.empty())
+    {
+        navi = router.retrace(scr, pos, exitCells);
+        ffwds++;
+    }
+    else
+    {
+        /* the agent moved straight towards the last target, which is still in sight then */
+        if (trgt)
+            navi = router.findVisible(scr, cIdx, pos, trgt, IdxTypeMax, rch);
+
+        if (navi)
+            hits++;
+        else
+        {
+            navi = router.findVisible(scr, cIdx, pos, std::nullopt, IdxTypeMax, rch);
+            misses++;
+        }
+    }
+
+    auto const & [lines, cells] { * navi };
+
+    trgt = cells.back();
 
     auto const & lastLine    { cells.back()                                  };
-    auto const   exitInSight { geometry.isExit(lastLine.cIdx, lastLine.sIdx) };
+    auto const   exitInSight { router.isExit(lastLine.cIdx, lastLine.sIdx)   };
+
+    // cut off from every exit (see 'Router::block'): the agent stays put,
+    // in sight of the others, and tries again in the next step, in case
+    // a line reopens
+    [[ unlikely ]]
+    if (rts and (not exitInSight) and std::isinf(router.lShrt(lastLine.cIdx, lastLine.sIdx)))
+    {
+        strd = true;
+        vel  = {};
+
+        path.back().second.emplace_back(pos);
+
+        {
+            std::unique_lock const lock { vueM };
+            oVue[cIdx].push_back({ pos, vel });
+        }
+        
+        {
+            std::unique_lock const lock { queM };
+            que.push(idx);
+        }
+
+        return;
+    }
+
+    if (fFlg and exitInSight and exitCells.empty())
+        exitCells.assign(cells.begin(), cells.end());
 
     auto const dptA { lineNorm(lines[0]) };                   // Avaiable 'dpt'
 
@@ -84,6 +152,10 @@ Actuator::operator()(std::queue<IdxType>       & que ,
         vel = where.second.v;
     
         auto const cIdxT { cells[where.first].cIdx };
+
+        /* the cells left behind */
+        if (not exitCells.empty())
+            exitCells.erase(exitCells.begin(), exitCells.begin() + where.first);
         
         if (cIdx != cIdxT)
             path.emplace_back(CellPathType { cIdxT, {} });
@@ -104,3 +176,113 @@ Actuator::operator()(std::queue<IdxType>       & que ,
 }
 
 
+FlowActuator::FlowActuator(IdxType            nIdx    ,
+                           IdxType            cIdx    ,
+                           smr::Point         pos     ,
+                           Geometry   const & geometry,
+                           Router     const & router  )
+
+    : Actuator { nIdx, cIdx, pos, geometry, router }
+{}
+
+
+void
+FlowActuator::operator()(std::queue<IdxType>       & que ,
+                         std::mutex                & queM,
+                         ViewType            const &     ,  /* others are not steered around */
+                         ViewType                  & oVue,
+                         std::mutex                & vueM)
+{
+    /* it is /out/ */
+    if (geometry.isDummy(cIdx))
+        return;
+
+    auto const & nosoz { geometry.getNosoz() };
+
+    strd = false;
+
+    /* the first line, as the visibility mode would pick it */
+    if (not trgt)
+    {
+        thread_local Router::ScratchType scr;
+
+        trgt = DuoType { cIdx, router.findLine(scr, cIdx, pos) };
+        misses++;
+    }
+    else
+        hits++;
+
+    auto const cIdxP { cIdx };
+
+    bool done { false };
+
+    dpt = dptM;
+
+    /* the distance left to travel in this step */
+    auto left { dpt };
+
+    while (true)
+    {
+        auto const head { linePoint(nosoz[cIdx][trgt->sIdx]) };
+        auto const dst  { euclideanDistance(pos, head)        };
+
+        if (left < dst)
+        {
+            vel = unitVctr(head - pos);
+            pos = pos + left * vel;
+
+            break;
+        }
+
+        if (dst > 0)
+            vel = unitVctr(head - pos);
+
+        pos   = head;
+        left -= dst;
+
+        auto const duoS { fld ? router.next(* fld, cIdx, trgt->sIdx) : router.next(cIdx, trgt->sIdx) };
+
+        /* a target: an EXIT is left, at any other the agent stays put */
+        if ((duoS.cIdx == cIdx) and (duoS.sIdx == trgt->sIdx))
+        {
+            if (router.isExit(cIdx, trgt->sIdx))
+                return;
+
+            /* cut off from every exit (see 'Router::block'), till a line reopens */
+            if ((not fld) and std::isinf(router.lShrt(cIdx, trgt->sIdx)))
+            {
+                strd = true;
+                vel  = {};
+            }
+            else
+                done = true;
+
+            break;
+        }
+
+        if (duoS.cIdx != cIdx)
+        {
+            pos  = router.translate(cIdx, duoS.cIdx, pos);
+            cIdx = duoS.cIdx;
+        }
+
+        trgt = duoS;
+    }
+
+    if (cIdx != cIdxP)
+        path.emplace_back(CellPathType { cIdx, {} });
+    path.back().second.emplace_back(pos);
+
+    {
+        std::unique_lock const lock { vueM };
+        oVue[cIdx].push_back({ pos, dpt * vel});
+    }
+
+    if (done)
+        return;
+
+    {
+        std::unique_lock const lock { queM };
+        que.push(idx);
+    }
+}
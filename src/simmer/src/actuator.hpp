@@ -41,11 +41,15 @@ public:
              Actuator() = delete;
     virtual ~Actuator() = default;
     
-    Actuator(IdxType            nIdx    ,
-             IdxType            cIdx    ,
-             smr::Point         pos     ,
-             Geometry   const & geometry,
-             Router     const & router  );
+    // fast-forward ('fFlg'): once the exit is in sight, the agent holds
+    // to the route found then, and only the lines from its position are
+    // drawn again, step by step
+    Actuator(IdxType            nIdx         ,
+             IdxType            cIdx         ,
+             smr::Point         pos          ,
+             Geometry   const & geometry     ,
+             Router     const & router       ,
+             bool               fFlg  = false);
 
                 Actuator(Actuator const & src) = delete;
     Actuator & operator=(Actuator const & rhs) = delete;
@@ -55,14 +59,26 @@ public:
     auto         getNIdx() const { return nIdx; }
     auto const & getPath() const { return path; }
 
+    /* steps whose visible target was revalidated, found afresh, or fast-forwarded */
+    std::tuple<IdxType, IdxType, IdxType>
+    getNaviCnts() const noexcept { return { hits, misses, ffwds }; }
+
     std::pair<IdxType, smr::Line>
     getWhere() const noexcept { return { cIdx, { pos, vel } }; }
+
+    /* stayed put in the last step, cut off from every exit (see 'Router::block') */
+    bool
+    isStranded() const noexcept { return strd; }
+
+    /* bounds the look-ahead to 'hrz' steps */
+    void
+    setHorizon(CrdType hrz) noexcept { rch = hrz * dptM; }
     
     virtual void
     operator()(std::queue<IdxType>       & que ,
                std::mutex                & queL,
-               ViewType            const   iVue,
-               ViewType                    oVue,
+               ViewType            const & iVue,
+               ViewType                  & oVue,
                std::mutex                & vueM);
 
 protected:
@@ -90,9 +106,30 @@ protected:
     /* maximum distance traveled per time step (velocity) */
     CrdType const dptM { DPTM };
 
+    /* look-ahead: visible targets further than this end the search */
+    CrdType rch { CrdTypeMax };
+
     /* history is made here */
     std::list<CellPathType> path;
 
+    /* the last visible target, ahead of 'pos' on its route */
+    std::optional<DuoType> trgt;
+
+    /* fast-forward flag */
+    bool const fFlg;
+
+    /* the cells on to the exit, from that of 'pos' (fast-forward) */
+    std::vector<DuoType> exitCells;
+
+    /* reroutes of the router as of the routes held (see 'Router::block') */
+    IdxType rts {};
+
+    bool strd {};
+
+    IdxType hits   {};
+    IdxType misses {};
+    IdxType ffwds  {};
+
     inline static IdxType gIdx {};
 
 public:
@@ -102,3 +139,35 @@ public:
 };
 
 
+// steers down the flow field of the router: from the line found for its
+// position at the outset, the agent walks the line points of the route to
+// the nearest exit ('Router::next'), or to the targets of a field, and
+// is done once there, at full speed; no sight lines are
+// drawn, so a step is a handful of lookups, at the cost of a route that
+// bends at the mesh lines rather than being pulled straight
+class FlowActuator : public Actuator
+{
+
+public:
+
+    FlowActuator(IdxType            nIdx    ,
+                 IdxType            cIdx    ,
+                 smr::Point         pos     ,
+                 Geometry   const & geometry,
+                 Router     const & router  );
+
+    /* heads for the targets of a field (see 'Router::field'), not the nearest exit */
+    void
+    setField(std::shared_ptr<Router::FieldType const> f) noexcept { fld = std::move(f); }
+
+    void
+    operator()(std::queue<IdxType>       & que ,
+               std::mutex                & queL,
+               ViewType            const & iVue,
+               ViewType                  & oVue,
+               std::mutex                & vueM) override;
+
+protected:
+
+    std::shared_ptr<Router::FieldType const> fld;
+};
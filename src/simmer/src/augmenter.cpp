@@ -23,21 +23,25 @@
  * SOFTWARE.
  */
 
+#include <cassert>
+
 #include "augmenter.hpp"
 #include "mesher.hpp"
 
 
-std::pair<std::vector<smr::Edge>, std::vector<TriangleType>>
+MeshType
 Augmenter::augment(std::vector<std::vector<smr::Point>> const & polys,
                    std::vector<smr::Line>               const & walls) const
 {
-    auto edges { subtractLines(mesher.mesh(polys), walls) };
+    auto [edgesM, tris] { mesher.mesh(polys) };
+
+    auto edges { subtractLines(std::move(edgesM), walls) };
     
     sortNCorrectNbrs(edges);
 
     uniqeNRename(edges, formUniques(edges));
 
-    return { edges, mesher.zerothOrderTriangles(polys) };
+    return { std::move(edges), std::move(tris) };
 }
 
 
@@ -45,12 +49,39 @@ std::vector<smr::Edge>
 subtractLines(std::vector<smr::Edge>       && edgesC,
               std::vector<smr::Line> const &  walls )
 {
+    // positions of 'edgesC' sorted by the exact end-point coordinates
+    // ('smr::Point' comparisons are tolerant and do not order strictly);
+    // ties are broken by position, so a lookup yields the first match,
+    // as a linear search of 'edgesC' would
+    auto const key
+    {
+        [] (auto const & e) { return std::tie(e.u.x, e.u.y, e.v.x, e.v.y); }
+    };
+    
+    std::vector<IdxType> srtd(edgesC.size());
+    std::iota(srtd.begin(), srtd.end(), 0);
+
+    std::sort(srtd.begin(), srtd.end(), [& edgesC, & key] (auto const & a, auto const & b)
+        {
+            return std::pair { key(edgesC[a]), a } < std::pair { key(edgesC[b]), b };
+        });
+    
     for (auto const & line : walls)
     {
 		smr::Edge const qeury { line.u, line.v, 0, 0, 0 };             // temp/find ctor
-        auto const itr { std::find(edgesC.begin(), edgesC.end(), qeury) };
+        auto const itr
+        {
+            std::lower_bound(srtd.cbegin(), srtd.cend(), key(qeury), [& edgesC, & key] (auto const & a, auto const & q)
+                {
+                    return key(edgesC[a]) < q;
+                })
+        };
 
-        auto & edge { * itr };
+        // the walls are constraint edges of the mesh, and CDT keeps their
+        // end-points verbatim, so the exact lookup always hits
+        assert((itr != srtd.cend()) and (edgesC[* itr] == qeury));
+
+        auto & edge { edgesC[* itr] };
         
         edge.idx = 0;                                         // signal SOLD line (wall)
 
@@ -75,19 +106,7 @@ sortNCorrectNbrs(std::vector<smr::Edge> & edges)
 {
     std::sort(edges.begin(), edges.end());
 
-    auto const m
-    {
-        [& edges]
-        {
-        
-        std::unordered_map<IdxType, IdxType> m;
-        m.reserve(edges.size());
-        for (IdxType i {}; i < edges.size(); i++)
-            m.insert({ edges[i].idx, i });
-
-        return m;
-        }()
-    };
+    auto const m { idxToPosition(edges) };
 
     // correct the record of nbrs of
     //   1.         the remaining one of duplicate edges
@@ -109,8 +128,7 @@ sortNCorrectNbrs(std::vector<smr::Edge> & edges)
                     // the search /has to/ be idx-based since duplicates (with
                     // identical endpoints) are present; it's also more
                     // efficient than coordinate-based search.
-                    // auto & nbrs { edges[m.at(nCIdx)].nbrs };
-                    auto & nbrs { edges[m.at(nCIdx)].nbrs };
+                    auto & nbrs { edges[m[nCIdx]].nbrs };
 
                     // exactly one match is replaced
                     auto itr { std::find(nbrs.begin(), nbrs.end(), e1.idx) };
@@ -163,18 +181,7 @@ uniqeNRename(std::vector<smr::Edge> &  edges ,
 {
     edges = edgesU;
 
-    auto const m
-    {
-        [& edges]
-        {
-            std::unordered_map<IdxType, IdxType> m;
-            m.reserve(edges.size());
-            for (IdxType i {}; i < edges.size(); i++)
-                m.insert({ edges[i].idx, i });
-
-            return m;
-        }()
-    };
+    auto const m { idxToPosition(edges) };
     
     /* rename idices */
     for (IdxType i {}; i < edges.size(); i++)
@@ -187,8 +194,7 @@ uniqeNRename(std::vector<smr::Edge> &  edges ,
             if (auto const & oldIdx { edgeU.nbrs[j] })
             {
                 // the search /has to/ be coordinate-based since edge.idx is changing
-                // auto const newIdx { m.at(oldIdx) };
-                auto const newIdx { m.at(oldIdx) };
+                auto const newIdx { m[oldIdx] };
                     
                 if (newIdx > i)
                 {
@@ -210,3 +216,18 @@ uniqeNRename(std::vector<smr::Edge> &  edges ,
 }
 
 
+std::vector<IdxType>
+idxToPosition(std::vector<smr::Edge> const & edges)
+{
+    // 'idx' values are bounded by the edge count of the mesh,
+    // so a dense table replaces a hash map
+    IdxType idxM {};
+    for (auto const & edge : edges)
+        idxM = std::max(idxM, edge.idx);
+    
+    std::vector<IdxType> m(idxM + 1);
+    for (IdxType i {}; i < edges.size(); i++)
+        m[edges[i].idx] = i;
+
+    return m;
+}
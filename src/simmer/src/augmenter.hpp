@@ -39,7 +39,7 @@ public:
     
     Augmenter(Mesher const & mesher) noexcept : mesher { mesher } {}
     
-    std::pair<std::vector<smr::Edge>, std::vector<TriangleType>>
+    MeshType
     augment(std::vector<std::vector<smr::Point>> const & polys,
             std::vector<smr::Line>               const & walls) const;
     
@@ -63,3 +63,5 @@ void
 uniqeNRename(std::vector<smr::Edge> &  edges ,
              std::vector<smr::Edge> && edgesU);
 
+std::vector<IdxType>
+idxToPosition(std::vector<smr::Edge> const & edges);
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2022 Shahir Mowlaei
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <set>
+
+#include "congruence.hpp"
+
+
+Congruence::MatchType
+Congruence::classify(Cell const & cell)
+{
+    auto const clrs { edgeColors(cell) };
+
+    auto & clss { clsz[signature(cell.getPolys(), clrs, QNT)] };
+
+    for (auto const & cls : clss)
+    {
+        MatchType match { cls, {}, {} };
+
+        if (this->match(* cls, cell, clrs, match))
+            return match;
+    }
+
+    auto cls { std::make_shared<ClassType>() };
+
+    cls->idxN  = cell.getIdx();
+    cls->polys = cell.getPolys();
+    cls->clrs  = std::move(clrs);
+
+    clss.push_back(cls);
+
+    return { std::move(cls), {}, {} };
+}
+
+
+bool
+Congruence::match(ClassType  const & cls  ,
+                  Cell       const & cell ,
+                  ColorzType const & clrs ,
+                  MatchType        & match) const
+{
+    auto const & polysT { cls.polys       };
+    auto const & polysC { cell.getPolys() };
+
+    auto const & outrT { polysT.front() };
+    auto const & outrC { polysC.front() };
+
+    auto const pSize { outrT.size() };
+
+    auto & snap { match.snap };
+    snap.resize(polysT.size());
+
+    /* anchor the first edge of the template on each edge of the copy */
+    for (IdxType j {}; j < pSize; j++)
+    {
+        auto const & p0 { outrT[0]               };
+        auto const & p1 { outrT[1]               };
+        auto const & q0 { outrC[j]               };
+        auto const & q1 { outrC[(j + 1) % pSize] };
+
+        if (std::abs(euclideanDistance(p0, p1) - euclideanDistance(q0, q1)) >= smr::Param::CPA)
+            continue;
+
+        DctType const dct { .tP = p0, .tS = q0, .a = vctrAngle(p1 - p0, q1 - q0) };
+
+        if (not matchPoly(outrT, cls.clrs.front(), outrC, clrs.front(), dct, j, snap.front()))
+            continue;
+
+        /* obstacles may be listed in any order */
+        std::vector<bool> used;
+        used.resize(polysC.size());
+
+        bool all { true };
+
+        for (IdxType k { 1 }; all and (k < polysT.size()); k++)
+        {
+            bool any { false };
+
+            for (IdxType l { 1 }; (not any) and (l < polysC.size()); l++)
+            {
+                if (used[l] or (polysC[l].size() != polysT[k].size()))
+                    continue;
+
+                for (IdxType s {}; (not any) and (s < polysC[l].size()); s++)
+                    any = matchPoly(polysT[k], cls.clrs[k], polysC[l], clrs[l], dct, s, snap[k]);
+
+                used[l] = any;
+            }
+
+            all = any;
+        }
+
+        if (all)
+        {
+            match.dct = dct;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/** Colors the poly edges of a cell after its walls and subsolid lines */
+Congruence::ColorzType
+edgeColors(Cell const & cell)
+{
+    using KeyType = std::tuple<CrdType, CrdType, CrdType, CrdType>;
+
+    auto const key
+    {
+        [] (smr::Line const & l) { return KeyType { l.u.x, l.u.y, l.v.x, l.v.y }; }
+    };
+
+    std::set<KeyType> walls;
+    std::set<KeyType> susos;
+
+    for (auto const & l : cell.getWalls())
+        walls.insert(key(l));
+
+    for (auto const & l : cell.getSusos())
+        susos.insert(key(l));
+
+    Congruence::ColorzType clrs;
+    clrs.reserve(cell.getPolys().size());
+
+    for (auto const & poly : cell.getPolys())
+    {
+        auto & clr { clrs.emplace_back() };
+        clr.reserve(poly.size());
+
+        for (IdxType i {}; i < poly.size(); i++)
+        {
+            smr::Line line { poly[i], poly[(i + 1) % poly.size()] };
+            orderPoints(line);
+
+            auto const k { key(line) };
+
+            if      (walls.contains(k)) clr.push_back(LineColor::SOLD);
+            else if (susos.contains(k)) clr.push_back(LineColor::INFC);
+            else                        clr.push_back(LineColor::META);
+        }
+    }
+
+    return clrs;
+}
+
+
+/** Poly sizes, edge colors, perimeters and areas, in that order */
+std::vector<IdxType>
+signature(std::vector<std::vector<smr::Point>> const & polys,
+          Congruence::ColorzType               const & clrs ,
+          CrdType                                      qnt  )
+{
+    std::vector<IdxType> sig { static_cast<IdxType>(polys.size()) };
+
+    auto const quantize
+    {
+        [qnt] (CrdType x) { return static_cast<IdxType>(std::llround(std::abs(x) / qnt)); }
+    };
+
+    for (IdxType k {}; k < polys.size(); k++)
+    {
+        auto const & poly { polys[k] };
+        auto const & clr  { clrs [k] };
+
+        std::array<IdxType, 4> cnt {};
+        for (auto const c : clr)
+            cnt[static_cast<LCType>(c)]++;
+
+        CrdType prm {};
+        CrdType are {};
+
+        for (IdxType i {}; i < poly.size(); i++)
+        {
+            auto const & u { poly[i]                      };
+            auto const & v { poly[(i + 1) % poly.size()] };
+
+            prm += euclideanDistance(u, v);
+            are += vctrCross(u, v);
+        }
+
+        sig.insert(sig.cend(), { static_cast<IdxType>(poly.size()), cnt[0], cnt[2], cnt[3], quantize(prm), quantize(are / 2) });
+    }
+
+    return sig;
+}
+
+
+/** Matches the 's'-shifted copy poly to the template poly, under 'dct' */
+bool
+matchPoly(std::vector<smr::Point> const & polyT,
+          std::vector<LineColor>  const & clrsT,
+          std::vector<smr::Point> const & polyC,
+          std::vector<LineColor>  const & clrsC,
+          DctType                 const & dct  ,
+          IdxType                         s    ,
+          std::vector<smr::Point>       & snap )
+{
+    auto const pSize { polyT.size() };
+
+    snap.clear();
+    snap.reserve(pSize);
+
+    for (IdxType i {}; i < pSize; i++)
+    {
+        auto const iS { (i + s) % pSize };
+
+        if (clrsT[i] != clrsC[iS])
+            return false;
+
+        if (euclideanDistance(transform(polyT[i], dct), polyC[iS]) >= smr::Param::CPA)
+            return false;
+
+        snap.push_back(polyC[iS]);
+    }
+
+    return true;
+}
+
+
+MeshType
+transformMesh(MeshType const & mesh, Congruence::MatchType const & match)
+{
+    auto const & dct { match.dct.value() };
+
+    // vertices of the template polys are mapped to the exact vertices of
+    // the copy, so that the lines of the copy can be matched exactly
+    std::map<std::pair<CrdType, CrdType>, smr::Point> snap;
+
+    auto const & polysT { match.cls->polys };
+
+    for (IdxType k {}; k < polysT.size(); k++)
+        for (IdxType i {}; i < polysT[k].size(); i++)
+            snap.insert({ { polysT[k][i].x, polysT[k][i].y }, match.snap[k][i] });
+
+    auto const map
+    {
+        [& snap, & dct] (smr::Point const & p)
+        {
+            auto const itr { snap.find({ p.x, p.y }) };
+
+            return (itr != snap.cend()) ? itr->second : transform(p, dct);
+        }
+    };
+
+    auto [edges, tris] { mesh };
+
+    for (auto & e : edges)
+    {
+        e.u = map(e.u);
+        e.v = map(e.v);
+
+        orderPoints(e);
+    }
+
+    for (auto & t : tris)
+        t = { map(t.u), map(t.v), map(t.w) };
+
+    return { std::move(edges), std::move(tris) };
+}
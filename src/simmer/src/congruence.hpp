@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022 Shahir Mowlaei
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <future>
+#include <map>
+#include <memory>
+
+#include "geometry/cell.hpp"
+
+
+// detects cells congruent, under rigid transforms, to a previously
+// classified cell (their template), so that the mesh and the local
+// routes of a template can be shared by its copies
+class Congruence
+{
+public:
+
+    using ColorzType = std::vector<std::vector<LineColor>>;
+
+    /* a congruence class, represented by its first cell */
+    struct ClassType
+    {
+        IdxType idxN {};  // nominal index of the template cell
+
+        std::vector<std::vector<smr::Point>> polys;
+        ColorzType                           clrs ;  // colors of the poly edges
+
+        /* published by the template once it is augmented */
+        std::promise<MeshType>       prm ;
+        std::shared_future<MeshType> mesh { prm.get_future().share() };
+    };
+
+    struct MatchType
+    {
+        std::shared_ptr<ClassType> cls;
+
+        /* template-to-copy transform; null for a template */
+        std::optional<DctType> dct;
+
+        /* copy vertices matched to the vertices of the template polys */
+        std::vector<std::vector<smr::Point>> snap;
+    };
+
+    // returns the class of the cell, opening a new one, of which
+    // the cell is the template, if no previous class matches it
+    MatchType
+    classify(Cell const & cell);
+
+    void
+    clear() noexcept { clsz.clear(); }
+
+protected:
+
+    bool
+    match(ClassType  const & cls  ,
+          Cell       const & cell ,
+          ColorzType const & clrs ,
+          MatchType        & match) const;
+
+    /* classes bucketed by a transform-invariant signature */
+    std::map<std::vector<IdxType>, std::vector<std::shared_ptr<ClassType>>> clsz;
+
+public:
+
+    /* quantum of the lengths and areas in signatures */
+    static CrdType constexpr QNT { .001 };
+};
+
+
+Congruence::ColorzType
+edgeColors(Cell const & cell);
+
+std::vector<IdxType>
+signature(std::vector<std::vector<smr::Point>> const & polys,
+          Congruence::ColorzType               const & clrs ,
+          CrdType                                      qnt  );
+
+bool
+matchPoly(std::vector<smr::Point> const & polyT,
+          std::vector<LineColor>  const & clrsT,
+          std::vector<smr::Point> const & polyC,
+          std::vector<LineColor>  const & clrsC,
+          DctType                 const & dct  ,
+          IdxType                         s    ,
+          std::vector<smr::Point>       & snap );
+
+/* maps the mesh of a template onto its (matched) copy */
+MeshType
+transformMesh(MeshType const & mesh, Congruence::MatchType const & match);
+
+
+inline smr::Point
+transform(smr::Point const & p, DctType const & d) noexcept
+{
+    return rotate(p - d.tP, d.a) + d.tS;
+}
@@ -42,16 +42,18 @@ Finder::findLocal(std::vector<std::vector<IdxType>> & pathMCSs,
                   std::vector<std::vector<CrdType>> & distMCSs) const
 {
     auto const & nosoz { geometry.getNosoz() };
+    auto const & tmplz { geometry.getTmplz() };
 
-    /* process cells in the order of their size */
+    /* process cells in the order of their size; copies share their template's */
     auto const nososSize
     {
-        [& nosoz]
+        [& nosoz, & tmplz]
         {
             std::vector<std::pair<IdxType, IdxType>> nososSize;
             nososSize.reserve(nosoz.size());
             for (IdxType i {}; i < nosoz.size(); i++)
-                nososSize.push_back({ i, nosoz[i].size() });
+                if (tmplz[i] == i)
+                    nososSize.push_back({ i, nosoz[i].size() });
 
             std::sort(nososSize.begin(), nososSize.end(),
                       [] <typename T> (T const & a, T const & b)
@@ -81,6 +83,39 @@ Finder::findLocal(std::vector<std::vector<IdxType>> & pathMCSs,
 }
 
 
+void
+Finder::findLocal(std::vector<std::vector<IdxType>> & pathMCSs,
+                  std::vector<std::vector<CrdType>> & distMCSs,
+                  IdxType                             idx     ) const
+{
+    formMCS(pathMCSs, distMCSs, idx);
+}
+
+
+void
+Finder::findInterface(std::vector<std::vector<IdxType>> & pathIMs,
+                      std::vector<std::vector<CrdType>> & distIMs) const
+{
+    auto const & tmplz { geometry.getTmplz() };
+
+    std::queue<IdxType> que;
+    for (IdxType i {}; i < tmplz.size(); i++)
+        if (tmplz[i] == i)
+            que.push(i);
+
+    auto const lambda
+    {
+        [this, & pathIMs, & distIMs] (auto const idx)
+        {
+            formIM(pathIMs, distIMs, idx);
+        }
+    };
+    
+    Spawner spawner { ntdi };
+    spawner.spawn<CallPattern::FNIDX>(que, lambda);
+}
+
+
 void
 Finder::pathFinderGlobal(std::vector<IdxType>       & pathM,
                          std::vector<CrdType>       & distM,
@@ -186,37 +221,93 @@ Finder::formMCS(std::vector<std::vector<IdxType>> & pathMCSs,
     pathMCS.resize(xSize * ySize);
     distMCS.resize(xSize * ySize);
 
-    auto const & nbrs { geometry.getNbrz()[idx] };
+    auto const g { formGraph(idx) };
+    
+    PairedIdxQueType que;
+    for (IdxType i {}; i < ySize; i++)
+        que.push({ susoExts[i].sIdx, i });
+    
+    pathFinderLocal(pathMCS, distMCS, g, que);
+}
 
-    auto const g
+
+void
+Finder::formIM(std::vector<std::vector<IdxType>> & pathIMs,
+               std::vector<std::vector<CrdType>> & distIMs,
+               IdxType                             idx    ) const
+{
+    auto const & susoExts { geometry.getSusoExtz()[idx] };
+    
+    IdxType const ySize { static_cast<IdxType>(susoExts.size()) };
+
+    auto & pathIM { pathIMs[idx] };
+    auto & distIM { distIMs[idx] };
+    
+    pathIM.assign(ySize * ySize, {});
+    distIM.assign(ySize * ySize, {});
+
+    auto const g { formGraph(idx) };
+
+    std::vector<IdxType> rows;
+    rows.reserve(ySize);
+    for (auto const & trio : susoExts)
+        rows.push_back(trio.sIdx);
+    
+    for (IdxType i {}; i < ySize; i++)
+        dijkstraPQIS(pathIM, distIM, g, rows, { susoExts[i].sIdx, i });
+}
+
+
+GraphType
+Finder::formGraph(IdxType idx) const
+{
+    return ::formGraph(geometry.getNosoz()[idx], geometry.getNbrz()[idx]);
+}
+
+
+GraphType
+formGraph(std::vector<smr::Line> const & nosos,
+          std::vector<IdxType>   const & nbrs )
+{
+    IdxType const xSize { static_cast<IdxType>(nosos.size()) };
+
+    GraphType g;
+    g.resize(xSize);
+
+    for (IdxType i {}; i < xSize; i++)
     {
-        [& nosos, & nbrs, xSize]
-        {
-            GraphType g;
-            g.resize(xSize);
+        auto const & line  { nosos[i] };
 
-            for (IdxType i {}; i < xSize; i++)
+        for (IdxType j {}; j < 4; j++)
+            if (auto const & J { nbrs[i * 4 + j] })
             {
-                auto const & line  { nosos[i] };
+                auto const Jm { J - 1 };
 
-                for (IdxType j {}; j < 4; j++)
-                    if (auto const & J { nbrs[i * 4 + j] })
-                    {
-                        auto const Jm { J - 1 };
-
-                        g[i].insert({ Jm, euclideanLLDistance(line, nosos[Jm]) });
-                    }
+                g[i].insert({ Jm, euclideanLLDistance(line, nosos[Jm]) });
             }
+    }
+
+    return g;
+}
+
+
+void
+formMCS(std::vector<smr::Line> const & nosos   ,
+        std::vector<IdxType>   const & nbrs    ,
+        std::vector<TriType>   const & susoExts,
+        std::vector<IdxType>         & pathMCS ,
+        std::vector<CrdType>         & distMCS )
+{
+    IdxType const xSize { static_cast<IdxType>(nosos   .size()) };
+    IdxType const ySize { static_cast<IdxType>(susoExts.size()) };
+
+    pathMCS.assign(xSize * ySize, {});
+    distMCS.assign(xSize * ySize, {});
+
+    auto const g { formGraph(nosos, nbrs) };
 
-            return g;
-        }()
-    };
-    
-    PairedIdxQueType que;
     for (IdxType i {}; i < ySize; i++)
-        que.push({ susoExts[i].sIdx, i });
-    
-    pathFinderLocal(pathMCS, distMCS, g, que);
+        dijkstraPQCS(pathMCS, distMCS, g, { susoExts[i].sIdx, i });
 }
 
 
@@ -285,6 +376,77 @@ dijkstraPQCS(std::vector<IdxType>              & pathMCS,
 }
 
 
+/**
+ * 'dijkstraPQCS' restricted to the 'rows' lines; stops once they are
+ * all settled, which leaves their entries as they would be otherwise
+ */
+void
+dijkstraPQIS(std::vector<IdxType>              & pathIM,
+             std::vector<CrdType>              & distIM,
+             GraphType                   const & g     ,
+             std::vector<IdxType>        const & rows  ,
+             std::pair<IdxType, IdxType> const   st    )
+{
+    auto const xSize { g.size()    };
+    auto const ySize { rows.size() };
+
+    auto const [s, t] { st };
+
+    // distance
+    std::vector<CrdType> d;
+    d.resize(xSize, std::numeric_limits<CrdType>::infinity());
+    d[s] = 0.;
+
+    // parent
+    std::vector<IdxType> p;
+    p.resize(xSize, IdxTypeMax);
+    p[s] = s;
+
+    // mask; 2 flags a row not yet settled
+    std::vector<std::uint8_t> m;
+    m.resize(xSize);
+    for (auto const r : rows)
+        m[r] = 2;
+
+    auto left { ySize };
+    
+    std::priority_queue<NbrType, std::vector<NbrType>, std::greater<NbrType>> q;
+    q.push({ 0., s });
+
+    while ((not q.empty()) and left)
+    {
+        auto const u { q.top().second };
+        q.pop();
+        
+        if (m[u] == 1)
+            continue;
+
+        if (m[u] == 2)
+            left--;
+        m[u] = 1;
+        
+        for (auto const & [v, wgt] : g[u])
+        {
+            auto const dv { d[u] + wgt };
+            
+            if (dv < d[v])
+            {
+                d[v] = dv;
+                p[v] = u;
+                
+                q.push({ d[v], v });
+            }
+        }
+    }
+
+    for (IdxType i {}; i < ySize; i++)
+    {
+        pathIM[i * ySize + t] = p[rows[i]];
+        distIM[i * ySize + t] = d[rows[i]];
+    }
+}
+
+
 /**
  * lazy implementation of Dijkstra SSSP
  * adpated from http://nmamano.com/blog/dijkstra/dijkstra.html
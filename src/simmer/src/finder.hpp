@@ -25,12 +25,20 @@
 
 #pragma once
 
+#include "geometry/line.hpp"
 #include "spawner.hpp"
 
 
 using NbrType   = std::pair<CrdType, IdxType>;
 using GraphType = std::vector<std::unordered_map<IdxType, CrdType>>;
 
+/* local matrices of all cells */
+struct MCSsType
+{
+    std::vector<std::vector<IdxType>> pathMCSs;
+    std::vector<std::vector<CrdType>> distMCSs;
+};
+
 class Geometry;
 
 class Finder
@@ -47,6 +55,18 @@ public:
     void
     findLocal(std::vector<std::vector<IdxType>> & pathMCSs,
               std::vector<std::vector<CrdType>> & distMCSs) const;
+
+    /* local matrices of a single cell */
+    void
+    findLocal(std::vector<std::vector<IdxType>> & pathMCSs,
+              std::vector<std::vector<CrdType>> & distMCSs,
+              IdxType                             idx     ) const;
+
+    // interface (subsolid-by-subsolid) blocks of the local matrices;
+    // rows and columns are in the order of 'susoExtz'
+    void
+    findInterface(std::vector<std::vector<IdxType>> & pathIMs,
+                  std::vector<std::vector<CrdType>> & distIMs) const;
     
     virtual void
     pathFinderGlobal(std::vector<IdxType>       & pathM,
@@ -71,6 +91,15 @@ protected:
     formMCS(std::vector<std::vector<IdxType>> & pathMCSs,
             std::vector<std::vector<CrdType>> & distMCSs,
             IdxType                             idx     ) const;
+
+    void
+    formIM(std::vector<std::vector<IdxType>> & pathIMs,
+           std::vector<std::vector<CrdType>> & distIMs,
+           IdxType                             idx    ) const;
+
+    /* graph of the nonsolid lines of a cell */
+    GraphType
+    formGraph(IdxType idx) const;
     
 public:
 
@@ -79,12 +108,33 @@ public:
 };
 
 
+/* graph of the nonsolid lines of a cell */
+GraphType
+formGraph(std::vector<smr::Line> const & nosos,
+          std::vector<IdxType>   const & nbrs );
+
+// local matrices of a cell, serially; needs only the cell's own
+// tables, so cells may be processed as soon as they are prepared
+void
+formMCS(std::vector<smr::Line> const & nosos   ,
+        std::vector<IdxType>   const & nbrs    ,
+        std::vector<TriType>   const & susoExts,
+        std::vector<IdxType>         & pathMCS ,
+        std::vector<CrdType>         & distMCS );
+
 void
 dijkstraPQCS(std::vector<IdxType>              & pathMCS,
              std::vector<CrdType>              & distMCS,
              GraphType                   const & g      ,
              std::pair<IdxType, IdxType> const   st     );
 
+void
+dijkstraPQIS(std::vector<IdxType>              & pathIM,
+             std::vector<CrdType>              & distIM,
+             GraphType                   const & g     ,
+             std::vector<IdxType>        const & rows  ,
+             std::pair<IdxType, IdxType> const   st    );
+
 void
 dijkstraPQ(GraphType            const & graph,
            std::vector<IdxType>       & pathM,
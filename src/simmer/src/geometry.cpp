@@ -23,19 +23,44 @@
  * SOFTWARE.
  */
 
+#include <bit>
 #include <utility>
 #include <queue>
 
 #include "geometry.hpp"
 
 
-Geometry::Geometry(Mesher const & mesher, bool vFlg) noexcept
+Geometry::Geometry(Mesher const & mesher,
+                   bool           vFlg  ,
+                   bool           cFlg  ,
+                   bool           mFlg  ,
+                   bool           oFlg  ,
+                   bool           pFlg  ) noexcept
         
     : augmenter { mesher },
-      vFlg      { vFlg   }
+      vFlg      { vFlg   },
+      cFlg      { cFlg   },
+      mFlg      { mFlg   },
+      oFlg      { oFlg   },
+      pFlg      { pFlg   }
 {}
 
 
+/* moves element 'i' of each table to 'rank[i]' */
+template <typename T>
+inline void
+permute(std::vector<T> & v, std::vector<IdxType> const & rank)
+{
+    std::vector<T> w;
+    w.resize(v.size());
+
+    for (IdxType i {}; i < v.size(); i++)
+        w[rank[i]] = std::move(v[i]);
+
+    v = std::move(w);
+}
+
+
 void
 Geometry::addParityFlag(IdxType cIdxP, IdxType cIdxS) noexcept
 {
@@ -44,53 +69,85 @@ Geometry::addParityFlag(IdxType cIdxP, IdxType cIdxS) noexcept
 }
 
 
+void
+Geometry::classifyCell(Cell const & cell, CellDataType & data)
+{
+    if (cFlg and cell.getIdx())
+        data.cgr = congruence.classify(cell);
+}
+
+
 std::optional<std::string>
-Geometry::processCell(Cell && cell) noexcept
+Geometry::prepareCell(Cell & cell, CellDataType & data) const
 {
     auto const cellIdxN { cell.getIdx() };
-    
+
     if (not cellIdxN)
         return {};
 
-    if (vFlg)
+    auto const & cgr { data.cgr };
+
+    MeshType mesh;
+
+    auto const augment
     {
-        if (cMap.contains(cellIdxN))
-            return fmt::format("duplicate cell index, {}, encountered", cellIdxN);
-        
-        if (auto const err { cell.validate() })
-            return err.value();
+        [this, & cell, & mesh] () -> std::optional<std::string>
+        {
+            if (vFlg)
+                if (auto const err { cell.validate() })
+                    return err.value();
+
+            mesh = augmenter.augment(cell.getPolys(), cell.getWalls());
+
+            return {};
+        }
+    };
+
+    if (cgr.dct)       /* a copy; its template is read, hence taken up, ahead of it */
+        mesh = transformMesh(cgr.cls->mesh.get(), cgr);
+    else if (cgr.cls)  /* a template; copies wait on it, so publish on every path   */
+    {
+        try
+        {
+            auto const err { augment() };
+
+            cgr.cls->prm.set_value(mesh);
+
+            if (err)
+                return err.value();
+        }
+        catch (...)
+        {
+            cgr.cls->prm.set_exception(std::current_exception());
+            throw;
+        }
     }
-    
-    auto [edges, tris] { augmenter.augment(cell.getPolys(), cell.getWalls()) };
-    
-    triz .emplace_back(std::move(tris         ));
-    wallz.emplace_back(std::move(cell.getWalls()));
+    else if (auto const err { augment() })
+        return err.value();
 
-    if (cell.isDummy())
-        dummys.insert(cellIdx);
+    auto & [edges, tris] { mesh };
 
-    cMapR.insert({ cellIdx,  cellIdxN  });
-    cMap .insert({ cellIdxN, cellIdx++ });
+    data.tris  = std::move(tris);
+    data.walls = cell.getWalls();
 
-    std::vector<IdxType> nbrs;
+    auto & nbrs { data.nbrs };
     nbrs.reserve(4 * edges.size());
     
     for (auto & e : edges)
         for (auto & nbr : e.nbrs)
             nbrs.emplace_back(std::move(nbr));
     nbrs.shrink_to_fit();
-    nbrz.emplace_back(std::move(nbrs));
 
-    std::vector<smr::Line> nosos;
+    auto & nosos { data.nosos };
     nosos.reserve(edges.size());
     for (auto const & e : edges)
         nosos.push_back({ e.u, e.v });
     nosos.shrink_to_fit();
-    
+
     auto const & susos    { cell.getSusos   () };
     auto       & susoExts { cell.getSusoExts() };
 
-    std::unordered_map<IdxType, IdxType> sMap;
+    auto & sMap { data.sMap };
     sMap.reserve(susos.size());
 
     std::unordered_map<IdxType, IdxType> SCMap;
@@ -130,12 +187,11 @@ Geometry::processCell(Cell && cell) noexcept
             SCMap.insert({ trio.sIdx, trio.cIdx });
         }
 
-    /* augment 'blobz' for the current cell */
+    /* form the blobs of the current cell */
     auto const & blobsC { cell.getBlobs() };
 
-    std::vector<BlobType> blobs;
-    
-    decltype(blobMaps)::value_type blobMap {};
+    auto & blobs   { data.blobs   };
+    auto & blobMap { data.blobMap };
 
     IdxType bIdx {};
     for (auto const & blobC : blobsC)
@@ -191,16 +247,93 @@ Geometry::processCell(Cell && cell) noexcept
         
         bIdx++;
     }
+
+    susoExts.shrink_to_fit();
+
+    data.susoExts = std::move(susoExts);
+
+    /* copies read the local matrices of their template */
+    if (mFlg and (not cgr.dct))
+        formMCS(data.nosos, data.nbrs, data.susoExts, data.pathMCS, data.distMCS);
+
+    return {};
+}
+
+
+std::optional<std::string>
+Geometry::processCell(Cell && cell)
+{
+    CellDataType data;
+
+    classifyCell(cell, data);
+
+    if (auto const err { prepareCell(cell, data) })
+        return err.value();
+
+    return processCell(std::move(cell), std::move(data));
+}
+
+
+std::optional<std::string>
+Geometry::processCell(Cell && cell, CellDataType && data) noexcept
+{
+    auto const cellIdxN { cell.getIdx() };
     
-    blobz   .emplace_back(std::move(blobs  ));
-    blobMaps.emplace_back(std::move(blobMap));
+    if (not cellIdxN)
+        return {};
+
+    if (vFlg)
+        if (cMap.contains(cellIdxN))
+            return fmt::format("duplicate cell index, {}, encountered", cellIdxN);
     
-    nosoz.emplace_back(std::move(nosos));
-    sMaps.emplace_back(std::move(sMap ));
+    if (cell.isDummy())
+        dummys.insert(cellIdx);
 
-    susoExts.shrink_to_fit();
+    /* a copy reads the local matrices of its template, column-permuted */
+    auto const & cgr { data.cgr };
+
+    auto & tIdx { tmplz.emplace_back(cellIdx) };
+    auto & perm { permz.emplace_back()        };
+
+    if (cgr.dct and cMap.contains(cgr.cls->idxN))
+    {
+        auto const & susoExtsT { susoExtz[cMap.at(cgr.cls->idxN)] };
+
+        std::unordered_map<IdxType, IdxType> cols;
+        for (IdxType i {}; i < susoExtsT.size(); i++)
+            cols.insert({ susoExtsT[i].sIdx, i });
+
+        for (auto const & trio : data.susoExts)
+            if (cols.contains(trio.sIdx))
+                perm.push_back(cols.at(trio.sIdx));
+
+        if (perm.size() == susoExtsT.size())
+            tIdx = cMap.at(cgr.cls->idxN);
+        else
+            perm.clear();
+    }
+
+    cMapR.insert({ cellIdx,  cellIdxN  });
+    cMap .insert({ cellIdxN, cellIdx++ });
+
+    triz    .emplace_back(std::move(data.tris    ));
+    wallz   .emplace_back(std::move(data.walls   ));
+    nbrz    .emplace_back(std::move(data.nbrs    ));
+    blobz   .emplace_back(std::move(data.blobs   ));
+    blobMaps.emplace_back(std::move(data.blobMap ));
+    nosoz   .emplace_back(std::move(data.nosos   ));
+    sMaps   .emplace_back(std::move(data.sMap    ));
+    susoExtz.emplace_back(std::move(data.susoExts));
+
+    if (mFlg)
+    {
+        pathMCSs.emplace_back(std::move(data.pathMCS));
+        distMCSs.emplace_back(std::move(data.distMCS));
 
-    susoExtz.emplace_back(std::move(susoExts));
+        /* a copy that could not be mapped onto its template */
+        if ((tIdx == (cellIdx - 1)) and cgr.dct)
+            formMCS(nosoz.back(), nbrz.back(), susoExtz.back(), pathMCSs.back(), distMCSs.back());
+    }
 
     /* process extra cell attributes */
     processCellExt(cell);
@@ -217,10 +350,20 @@ Geometry::finalize()
             return err.value();
     
     patchUp          ();
+
+    if (oFlg)
+        reorder      ();
+
     shrink           ();
     constructSusoMaps();
+
+    if (pFlg)
+        formPVSs     ();
+
     finalizeExt      ();
 
+    congruence.clear();
+
     return {};
 }
 
@@ -323,10 +466,10 @@ Geometry::intersectsWalls(smr::Line const & l, IdxType cIdx, CrdType cpa) const
 
 
 bool
-Geometry::intersectsWalls(smr::Line                   const & l      ,
-                          IdxType                             cIdx   ,
-                          std::unordered_set<IdxType> const & pseudos,
-                          CrdType                             cpa    ) const noexcept
+Geometry::intersectsWalls(smr::Line          const & l      ,
+                          IdxType                    cIdx   ,
+                          std::span<IdxType const>   pseudos,
+                          CrdType                    cpa    ) const noexcept
 {
     for (auto const & w : wallz[cIdx])
         if (intersectionFlag(l, w) or fELess(nonIntSegmentDistance(l, w), cpa))
@@ -346,6 +489,57 @@ Geometry::intersectsWalls(smr::Line                   const & l      ,
 }
 
 
+bool
+Geometry::intersectsWallsTo(smr::Line const & l, IdxType cIdx, IdxType sIdx, CrdType cpa) const noexcept
+{
+    /* the sets hold for no wider clearance */
+    if (pvsz.empty() or pvsz[cIdx].empty() or (cpa > pvsCpa))
+        return intersectsWalls(l, cIdx, cpa);
+
+    auto const & rows { pvsz[cIdx] };
+
+    auto const & walls { wallz[cIdx] };
+
+    auto const   words { pvsWords[cIdx] };
+    auto const * row   { rows.data() + sIdx * words };
+
+    for (IdxType i {}; i < words; i++)
+        for (auto bits { row[i] }; bits; bits &= bits - 1)
+        {
+            auto const & w { walls[i * 64 + std::countr_zero(bits)] };
+
+            if (intersectionFlag(l, w) or fELess(nonIntSegmentDistance(l, w), cpa))
+                return true;
+        }
+
+    return false;
+}
+
+
+bool
+Geometry::intersectsWallsTo(smr::Line          const & l      ,
+                            IdxType                    cIdx   ,
+                            IdxType                    sIdx   ,
+                            std::span<IdxType const>   pseudos,
+                            CrdType                    cpa    ) const noexcept
+{
+    if (intersectsWallsTo(l, cIdx, sIdx, cpa))
+        return true;
+
+    auto const & nosos { nosoz[cIdx] };
+    
+    for (auto const idx : pseudos)
+    {
+        auto const & w { nosos[idx] };
+
+        if (intersectionFlag(l, w) or fELess(nonIntSegmentDistance(l, w), cpa))
+            return true;
+    }
+    
+    return false;
+}
+
+
 /** Returns the number of non-solid lines in a cell */
 std::vector<IdxType>
 Geometry::linesPerCell() const
@@ -368,109 +562,171 @@ Geometry::linesPerCell() const
 std::optional<std::string>
 Geometry::validate() const
 {
-    /* isolated cells: it is an error if 'isos' remains non-empty */
-    std::unordered_set<IdxType> isos;
-    for (IdxType i {}; i < cellIdx; i++)
-        isos.insert(i);
-    
-    std::vector<bool> mask;
-    mask.resize(cellIdx);
+    // reverse of 'sMaps' (line index to 's-index'), and line index to
+    // position in 'susoExtz'; IdxTypeMax marks non-subsolid lines
+    std::vector<std::vector<IdxType>> sMapRz;
+    std::vector<std::vector<IdxType>> colz  ;
+    sMapRz.resize(cellIdx);
+    colz  .resize(cellIdx);
 
-    std::queue<IdxType> que;
+    /* neighbors of a cell across its interface lines */
+    std::vector<std::vector<IdxType>> adjz;
+    adjz.resize(cellIdx);
 
-    std::unordered_map<IdxType, std::unordered_set<IdxType>> nbrz;
-    
-    for (IdxType i {}; i < cellIdx; i++)
+    /* written concurrently, hence not 'std::vector<bool>' */
+    std::vector<std::uint8_t> exits;
+    exits.resize(cellIdx);
+
+    /* cells are checked in blocks; errors are reported in cell order */
+    auto const bSize { (cellIdx + BLK - 1) / BLK };
+    auto const ntd   { static_cast<ThreadCntType>(std::min<IdxType>(NTD, bSize)) };
+
+    std::vector<std::optional<std::string>> errs;
+    errs.resize(bSize);
+
+    auto const blocks
     {
-        auto const & susoExts { susoExtz[i] };
-        auto const & sMap     { sMaps[i]    };
+        [bSize]
+        {
+            std::queue<IdxType> que;
+            for (IdxType b {}; b < bSize; b++)
+                que.push(b);
 
-        bool directExit {};
-        
-        std::unordered_set<IdxType> nbrs;
+            return que;
+        }
+    };
 
-        for (IdxType j {}; j < susoExts.size(); j++)
+    auto que { blocks() };
+    Spawner { ntd }.spawn<CallPattern::FNIDX>(que,
+        [this, & sMapRz, & colz] (IdxType b)
         {
-            auto const & trioP { susoExts[j] };
+            for (IdxType i { b * BLK }; i < std::min((b + 1) * BLK, cellIdx); i++)
+            {
+                auto const & susoExts { susoExtz[i] };
 
-            [[ unlikely ]]
-            if (not cMap.contains(trioP.cIdx))
-                return fmt::format("invalid target cell index encountered in cell {}:\nsIdx : ?\ncIdx : {}\noIdx : {}\n",
-                                   cMapR.at(i), trioP.cIdx, trioP.oIdx);
+                auto & sMapR { sMapRz[i] };
+                auto & cols  { colz  [i] };
+                sMapR.resize(nosoz[i].size(), IdxTypeMax);
+                cols .resize(nosoz[i].size(), IdxTypeMax);
 
-            auto const cIdxS { cMap.at(trioP.cIdx) };
+                for (auto const & [sIdxN, sIdx] : sMaps[i])
+                    sMapR[sIdx] = sIdxN;
 
-            [[ unlikely ]]
-            if (cIdxS == i)  /* ignore EXIT lines */
-            {
-                directExit = true;
-                
-                continue;
+                for (IdxType j {}; j < susoExts.size(); j++)
+                    cols[susoExts[j].sIdx] = j;
             }
+        });
 
-            nbrs.insert(cIdxS);
-            
-            auto const sIdxPF { (* std::find_if(sMap.cbegin(), sMap.cend(),
-                                                [& trioP] (auto const & pair) { return pair.second == trioP.sIdx; })).first };
+    auto const check
+    {
+        [this, & sMapRz, & colz, & adjz, & exits] (IdxType i) -> std::optional<std::string>
+        {
+            auto const & susoExts { susoExtz[i] };
+            auto const & sMapR    { sMapRz[i]   };
 
-            [[ unlikely ]]
-            if (not sMaps[cIdxS].contains(trioP.oIdx))
-                return fmt::format("invalid target line index encountered in cell {}:\nsIdx : {}\ncIdx : {}\noIdx : {}\n",
-                                   cMapR.at(i), sIdxPF, trioP.cIdx, trioP.oIdx);
-            
-            auto const sIdxS { sMaps[cIdxS].at(trioP.oIdx) };
+            auto & adjs { adjz[i] };
+
+            for (IdxType j {}; j < susoExts.size(); j++)
+            {
+                auto const & trioP { susoExts[j] };
+
+                [[ unlikely ]]
+                if (not cMap.contains(trioP.cIdx))
+                    return fmt::format("invalid target cell index encountered in cell {}:\nsIdx : ?\ncIdx : {}\noIdx : {}\n",
+                                       cMapR.at(i), trioP.cIdx, trioP.oIdx);
+
+                auto const cIdxS { cMap.at(trioP.cIdx) };
 
-            auto const & susoExtsS { susoExtz[cIdxS] };
+                [[ unlikely ]]
+                if (cIdxS == i)  /* ignore EXIT lines */
+                {
+                    exits[i] = true;
 
-            auto const itr { std::find_if(susoExtsS.cbegin(), susoExtsS.cend(),
-                                         [& sIdxS] (TriType trio)
-                                             { return (trio.sIdx == sIdxS); }) };
+                    continue;
+                }
 
-            [[ unlikely ]]
-            if (itr == susoExtsS.cend())
-                return fmt::format("forward dual not found in cell {}:\nsIdx : {}\ncIdx : {}\noIdx : {}\n",
-                                   cMapR.at(i), sIdxPF, trioP.cIdx, trioP.oIdx);
+                adjs.push_back(cIdxS);
 
-            auto const & trioS { * itr };
+                auto const sIdxPF { sMapR[trioP.sIdx] };
 
-            [[ unlikely ]]
-            if ((i != cMap.at(trioS.cIdx)) or (trioS.oIdx != sIdxPF) or (not cMap.contains(trioS.cIdx)))
-                return fmt::format("roundtrip mismatch encountered in cell {}\n", cMapR.at(i)) +
-                    fmt::format("source trio:\nsIdx : {}\ncIdx : {}\noIdx : {}\n",
-                               sIdxPF, trioP.cIdx, trioP.oIdx) +
-                    fmt::format("target trio:\nsIdx : {}\ncIdx : {}\noIdx : {}\n",
-                               trioP.oIdx, trioS.cIdx, trioS.oIdx);
+                [[ unlikely ]]
+                if (not sMaps[cIdxS].contains(trioP.oIdx))
+                    return fmt::format("invalid target line index encountered in cell {}:\nsIdx : {}\ncIdx : {}\noIdx : {}\n",
+                                       cMapR.at(i), sIdxPF, trioP.cIdx, trioP.oIdx);
+
+                auto const col { colz[cIdxS][sMaps[cIdxS].at(trioP.oIdx)] };
+
+                [[ unlikely ]]
+                if (col == IdxTypeMax)
+                    return fmt::format("forward dual not found in cell {}:\nsIdx : {}\ncIdx : {}\noIdx : {}\n",
+                                       cMapR.at(i), sIdxPF, trioP.cIdx, trioP.oIdx);
+
+                auto const & trioS { susoExtz[cIdxS][col] };
+
+                [[ unlikely ]]
+                if ((not cMap.contains(trioS.cIdx)) or (i != cMap.at(trioS.cIdx)) or (trioS.oIdx != sIdxPF))
+                    return fmt::format("roundtrip mismatch encountered in cell {}\n", cMapR.at(i)) +
+                        fmt::format("source trio:\nsIdx : {}\ncIdx : {}\noIdx : {}\n",
+                                   sIdxPF, trioP.cIdx, trioP.oIdx) +
+                        fmt::format("target trio:\nsIdx : {}\ncIdx : {}\noIdx : {}\n",
+                                   trioP.oIdx, trioS.cIdx, trioS.oIdx);
+            }
+
+            return {};
         }
+    };
 
-        nbrz[i] = std::move(nbrs);
-        
-        if (directExit)
-            que.push(i);
-    }
+    que = blocks();
+    Spawner { ntd }.spawn<CallPattern::FNIDX>(que,
+        [this, & check, & errs] (IdxType b)
+        {
+            for (IdxType i { b * BLK }; (i < std::min((b + 1) * BLK, cellIdx)) and (not errs[b]); i++)
+                errs[b] = check(i);
+        });
+
+    for (auto const & err : errs)
+        if (err)
+            return err.value();
 
-    while (not que.empty())
+    // with roundtrips verified, adjacency is symmetric: a cell
+    // reaches an exit iff its component (union-find) contains one
+    std::vector<IdxType> roots;
+    roots.resize(cellIdx);
+    std::iota(roots.begin(), roots.end(), IdxType {});
+
+    auto const find
     {
-        auto const & u { que.front() };
+        [& roots] (IdxType u)
+        {
+            while (roots[u] != u)
+                u = roots[u] = roots[roots[u]];
 
-        mask[u] = true;
-        isos.erase(u);
-        
-        for (auto const & nbr : nbrz.at(u))
-            if (not mask[nbr])
-                que.push(nbr);
+            return u;
+        }
+    };
 
-        que.pop();
-    }
-    
-    if (not isos.empty())
+    for (IdxType i {}; i < cellIdx; i++)
+        for (auto const j : adjz[i])
+            roots[find(j)] = find(i);
+
+    std::vector<bool> reach;
+    reach.resize(cellIdx);
+
+    for (IdxType i {}; i < cellIdx; i++)
+        if (exits[i])
+            reach[find(i)] = true;
+
+    std::string error;
+
+    for (IdxType i {}; i < cellIdx; i++)
+        if (not reach[find(i)])
+            error += fmt::format(" {},", cMapR.at(i));
+
+    if (not error.empty())
     {
-        std::string error { fmt::format("the following cells have no route to an exit:") };
-        
-        for (auto const & iso : isos)
-            error += fmt::format(" {},", cMapR.at(iso));
         error.pop_back();
 
-        return error;
+        return fmt::format("the following cells have no route to an exit:") + error;
     }
 
     return {};
@@ -480,25 +736,96 @@ Geometry::validate() const
 void
 Geometry::patchUp() noexcept
 {
-    for (IdxType i {}; i < susoExtz.size(); i++)
+    /* lookups only ('0' if absent), as the maps are read concurrently */
+    auto const at
     {
-        auto & susoExt { susoExtz[i] };
-
-        for (IdxType j {}; j < susoExt.size(); j++)
+        [] (auto const & map, IdxType key)
         {
-            auto & cIdx { susoExt[j].cIdx };
-            cIdx = cMap[cIdx];
+            auto const itr { map.find(key) };
 
-            auto & oIdx { susoExt[j].oIdx };
-            oIdx = sMaps[cIdx][oIdx];
+            return (itr != map.cend()) ? itr->second : IdxType {};
         }
-    }
+    };
+
+    spawnBlocks(NTD, susoExtz.size(), BLK,
+        [this, & at] (IdxType bgn, IdxType end)
+        {
+            for (IdxType i { bgn }; i < end; i++)
+                for (auto & trio : susoExtz[i])
+                {
+                    trio.cIdx = at(cMap, trio.cIdx);
+                    trio.oIdx = at(sMaps[trio.cIdx], trio.oIdx);
+                }
+        });
 
     /* update pMaps */
     decltype(pMaps) pMapsT;
-    for (IdxType i {}; i < nosoz.size(); i++)
-        for (auto const & cIdxS : pMaps[cMapR[i]])
-            pMapsT[i].insert(cMap[cIdxS]);
+    for (auto const & [cIdxN, cIdxSs] : pMaps)
+        if (cMap.contains(cIdxN))
+            for (auto const & cIdxS : cIdxSs)
+                pMapsT[cMap.at(cIdxN)].insert(at(cMap, cIdxS));
+    pMaps = std::move(pMapsT);
+}
+
+
+/** Renumbers cells */
+void
+Geometry::reorder()
+{
+    auto const xSize { nosoz.size() };
+
+    /* the graph of cells is that of interface lines */
+    std::vector<std::vector<IdxType>> adjz;
+    adjz.resize(xSize);
+
+    for (IdxType i {}; i < xSize; i++)
+        for (auto const & trio : susoExtz[i])
+            if (trio.cIdx != i)
+                adjz[i].push_back(trio.cIdx);
+
+    auto const rank { rcmOrder(adjz) };
+
+    for (auto & susoExts : susoExtz)
+        for (auto & trio : susoExts)
+            trio.cIdx = rank[trio.cIdx];
+
+    for (auto & tIdx : tmplz)
+        tIdx = rank[tIdx];
+
+    permute(triz    , rank);
+    permute(wallz   , rank);
+    permute(susoExtz, rank);
+    permute(nosoz   , rank);
+    permute(nbrz    , rank);
+    permute(sMaps   , rank);
+    permute(blobz   , rank);
+    permute(blobMaps, rank);
+    permute(tmplz   , rank);
+    permute(permz   , rank);
+
+    if (mFlg)
+    {
+        permute(pathMCSs, rank);
+        permute(distMCSs, rank);
+    }
+
+    decltype(cMapR) cMapRT;
+    for (auto & [cIdxN, cIdx] : cMap)
+    {
+        cIdx = rank[cIdx];
+        cMapRT.insert({ cIdx, cIdxN });
+    }
+    cMapR = std::move(cMapRT);
+
+    decltype(dummys) dummysT;
+    for (auto const cIdx : dummys)
+        dummysT.insert(rank[cIdx]);
+    dummys = std::move(dummysT);
+
+    decltype(pMaps) pMapsT;
+    for (auto const & [cIdxP, cIdxSs] : pMaps)
+        for (auto const cIdxS : cIdxSs)
+            pMapsT[rank[cIdxP]].insert(rank[cIdxS]);
     pMaps = std::move(pMapsT);
 }
 
@@ -516,24 +843,178 @@ Geometry::shrink() noexcept
 }
 
 
+// a wall is left out of the set of a line if, seen from its line point
+// 'm', the wall's clearance zone is hidden behind walls that lie wholly
+// closer to 'm': every ray from 'm' into the zone crosses one of them
+// first, and so would any line from 'm' that comes within 'cpa' of it
 void
-Geometry::constructSusoMaps()
+Geometry::formPVSs()
 {
-    susoMaps.reserve(susoExtz.size());
+    pvsCpa = smr::Param::CPA;
+
+    pvsz    .assign(wallz.size(), {});
+    pvsWords.assign(wallz.size(), {});
 
-    for (auto const & susoExts : susoExtz)
+    auto const Pi  { std::numbers::pi_v<CrdType> };
+    auto const cpa { pvsCpa * (1 + PVS_EPS) + PVS_EPS };
+
+    /* a wall, as seen from 'm' */
+    struct ViewType
+    {
+        CrdType aU {};  // angles of the end-points
+        CrdType aV {};
+        CrdType dU {};  // distances of the end-points
+        CrdType dV {};
+        CrdType dW {};  // distance of the wall
+    };
+
+    /* angle 'a' (of 'atan2') off 'ref' (within 3 Pi of it), in [-Pi, Pi] */
+    auto const off
     {
-        std::unordered_map<IdxType, TriType> susoMap;
-        susoMap.reserve(susoExts.size());
+        [Pi] (CrdType a, CrdType ref)
+        {
+            auto const d { a - ref };
+
+            return (d > Pi) ? (d - 2 * Pi) : ((d < -Pi) ? (d + 2 * Pi) : d);
+        }
+    };
 
-        for (IdxType i {}; i < susoExts.size(); i++)
+    auto const hidden
+    {
+        [Pi, cpa, & off] (std::vector<ViewType>                    const & views,
+                          IdxType                                          wIdx ,
+                          std::vector<std::pair<CrdType, CrdType>>       & spans)
         {
-            auto const & t { susoExts[i] };
-            susoMap.insert({ t.sIdx, { i, t.cIdx, t.oIdx } });
+            auto const & vw { views[wIdx] };
+
+            auto const dMin { vw.dW - cpa };
+
+            if (dMin <= 0)
+                return false;
+
+            auto const ref { vw.aU + off(vw.aV, vw.aU) / 2 };
+
+            /* angular extent of the zone, from the discs at the end-points */
+            auto const hU { std::asin(std::min<CrdType>(1, cpa / vw.dU)) };
+            auto const hV { std::asin(std::min<CrdType>(1, cpa / vw.dV)) };
+
+            auto lo { std::min(off(vw.aU, ref) - hU, off(vw.aV, ref) - hV) - PVS_EPS };
+            auto hi { std::max(off(vw.aU, ref) + hU, off(vw.aV, ref) + hV) + PVS_EPS };
+
+            if ((lo <= -Pi) or (hi >= Pi))
+                return false;
+
+            spans.clear();
+
+            for (IdxType i {}; i < views.size(); i++)
+            {
+                auto const & vo { views[i] };
+
+                if ((i == wIdx) or (std::max(vo.dU, vo.dV) >= dMin) or (vo.dW <= cpa))
+                    continue;
+
+                auto const a0 { off(vo.aU, ref) };
+                auto const a1 { off(vo.aV, ref) };
+
+                /* off to the back */
+                if (std::fabs(a0 - a1) >= Pi)
+                    continue;
+
+                spans.emplace_back(std::min(a0, a1), std::max(a0, a1));
+            }
+
+            std::sort(spans.begin(), spans.end());
+
+            for (auto const & [a0, a1] : spans)
+            {
+                if (a0 > lo)
+                    return false;
+
+                lo = std::max(lo, a1);
+
+                if (lo >= hi)
+                    return true;
+            }
+
+            return false;
         }
+    };
 
-        susoMaps.emplace_back(std::move(susoMap));
-    }
+    spawnBlocks(NTD, wallz.size(), BLK,
+        [this, & hidden] (IdxType bgn, IdxType end)
+        {
+            std::vector<ViewType> views;
+
+            std::vector<std::pair<CrdType, CrdType>> spans;
+
+            for (IdxType c { bgn }; c < end; c++)
+            {
+                auto const & walls { wallz[c] };
+                auto const & nosos { nosoz[c] };
+
+                IdxType const words { static_cast<IdxType>((walls.size() + 63) / 64) };
+
+                std::vector<std::uint64_t> rows(nosos.size() * words);
+
+                bool any { false };
+
+                for (IdxType s {}; s < nosos.size(); s++)
+                {
+                    auto const m { linePoint(nosos[s]) };
+
+                    views.clear();
+
+                    for (auto const & w : walls)
+                    {
+                        auto const u { w.u - m };
+                        auto const v { w.v - m };
+
+                        views.push_back({ std::atan2(u.y, u.x)       ,
+                                          std::atan2(v.y, v.x)       ,
+                                          euclideanDistance(m, w.u)  ,
+                                          euclideanDistance(m, w.v)  ,
+                                          pointLineDistance(m, w)    });
+                    }
+
+                    for (IdxType w {}; w < walls.size(); w++)
+                        if (hidden(views, w, spans))
+                            any = true;
+                        else
+                            rows[s * words + w / 64] |= std::uint64_t { 1 } << (w % 64);
+                }
+
+                if (any)
+                {
+                    pvsz    [c] = std::move(rows);
+                    pvsWords[c] = words;
+                }
+            }
+        });
+}
+
+
+void
+Geometry::constructSusoMaps()
+{
+    susoMaps.resize(susoExtz.size());
+
+    spawnBlocks(NTD, susoExtz.size(), BLK,
+        [this] (IdxType bgn, IdxType end)
+        {
+            for (IdxType i { bgn }; i < end; i++)
+            {
+                auto const & susoExts { susoExtz[i] };
+
+                auto & susoMap { susoMaps[i] };
+                susoMap.reserve(susoExts.size());
+
+                for (IdxType j {}; j < susoExts.size(); j++)
+                {
+                    auto const & t { susoExts[j] };
+                    susoMap.insert({ t.sIdx, { j, t.cIdx, t.oIdx } });
+                }
+            }
+        });
 }
 
 
@@ -552,3 +1033,61 @@ isInsideTriangle(smr::Point const & p, TriangleType const & t) noexcept
         or (fELess(l1, 0.) and fELess(l2, 0.) and fELess(l3, 0.));
 }
 
+
+/**
+ * Breadth-first from a vertex of least degree, per component,
+ * visiting neighbors by increasing degree; the order is reversed
+ */
+std::vector<IdxType>
+rcmOrder(std::vector<std::vector<IdxType>> const & adjz)
+{
+    auto const xSize { adjz.size() };
+
+    auto const deg { [& adjz] (IdxType u) { return adjz[u].size(); } };
+
+    std::vector<IdxType> vtxs;
+    vtxs.resize(xSize);
+    std::iota(vtxs.begin(), vtxs.end(), IdxType {});
+    std::stable_sort(vtxs.begin(), vtxs.end(), [& deg] (IdxType a, IdxType b) { return deg(a) < deg(b); });
+
+    std::vector<IdxType> order;
+    order.reserve(xSize);
+
+    std::vector<bool> seen;
+    seen.resize(xSize);
+
+    std::vector<IdxType> nbrs;
+
+    for (auto const s : vtxs)
+    {
+        if (seen[s])
+            continue;
+
+        seen[s] = true;
+        order.push_back(s);
+
+        for (auto h { static_cast<IdxType>(order.size() - 1) }; h < order.size(); h++)
+        {
+            nbrs.clear();
+
+            for (auto const v : adjz[order[h]])
+                if (not seen[v])
+                {
+                    seen[v] = true;
+                    nbrs.push_back(v);
+                }
+
+            std::stable_sort(nbrs.begin(), nbrs.end(), [& deg] (IdxType a, IdxType b) { return deg(a) < deg(b); });
+
+            order.insert(order.end(), nbrs.cbegin(), nbrs.cend());
+        }
+    }
+
+    std::vector<IdxType> rank;
+    rank.resize(xSize);
+
+    for (IdxType i {}; i < xSize; i++)
+        rank[order[xSize - 1 - i]] = i;
+
+    return rank;
+}
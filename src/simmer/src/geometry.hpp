@@ -25,10 +25,12 @@
 
 #pragma once
 
+#include <span>
 #include <unordered_set>
 
 #include "augmenter.hpp"
-#include "geometry/cell.hpp"
+#include "congruence.hpp"
+#include "finder.hpp"
 
 
 class Mesher;
@@ -40,18 +42,64 @@ public:
              Geometry() = delete;
     virtual ~Geometry() = default;
     
-    Geometry(Mesher const & mesher, bool vFlg = true) noexcept;
+    Geometry(Mesher const & mesher      ,
+             bool           vFlg = true ,
+             bool           cFlg = false,
+             bool           mFlg = false,
+             bool           oFlg = false,
+             bool           pFlg = false) noexcept;
+
+    /* per-cell product of 'prepareCell', consumed by 'processCell' */
+    struct CellDataType
+    {
+        std::vector<TriangleType> tris    ;
+        std::vector<smr::Line>    walls   ;
+        std::vector<smr::Line>    nosos   ;
+        std::vector<IdxType>      nbrs    ;
+        std::vector<TriType>      susoExts;
+        std::vector<BlobType>     blobs   ;
+
+        std::unordered_map<IdxType, IdxType> sMap   ;
+        std::unordered_map<IdxType, IdxType> blobMap;
+
+        /* set by 'classifyCell' */
+        Congruence::MatchType cgr;
+
+        /* local matrices (see 'mFlg') */
+        std::vector<IdxType> pathMCS;
+        std::vector<CrdType> distMCS;
+    };
 
     void
     addParityFlag(IdxType cIdxP, IdxType cIdxS) noexcept;
-    
+
+    // ordered stage, in read order: matches the cell against the cells
+    // classified so far; copies of a template take its mesh (in
+    // 'prepareCell') and its local routes (see 'Router'); no-op unless 'cFlg'
+    void
+    classifyCell(Cell const & cell, CellDataType & data);
+
+    // per-cell stage: validation, meshing and local indexing (and local
+    // routing); touches no shared state, hence safe to call concurrently
     std::optional<std::string>
-    processCell(Cell && cell) noexcept;
+    prepareCell(Cell & cell, CellDataType & data) const;
+
+    // ordered stage: assigns the sequential cell index and
+    // appends a prepared cell to 'Geometry'
+    std::optional<std::string>
+    processCell(Cell && cell, CellDataType && data) noexcept;
+
+    std::optional<std::string>
+    processCell(Cell && cell);
 
     /* called after 'Parser' augments 'Geometry' */
     std::optional<std::string>
     finalize();
 
+    /* hands the local matrices over (to 'Router'); empty unless 'mFlg' */
+    MCSsType
+    releaseMCSs() noexcept { return { std::move(pathMCSs), std::move(distMCSs) }; }
+
     /* bool (*)(cIdx, sIdx) */
     bool isInterface(IdxType, IdxType) const;
     bool isSubsolid (IdxType, IdxType) const;
@@ -73,10 +121,25 @@ public:
                     CrdType           cpa = smr::Param::CPA) const noexcept;
 
     bool
-    intersectsWalls(smr::Line                   const & l                    ,
-                    IdxType                             cIdx                 ,
-                    std::unordered_set<IdxType> const & pseudos              ,
-                    CrdType                             cpa = smr::Param::CPA) const noexcept;
+    intersectsWalls(smr::Line          const & l                    ,
+                    IdxType                    cIdx                 ,
+                    std::span<IdxType const>   pseudos              ,
+                    CrdType                    cpa = smr::Param::CPA) const noexcept;
+
+    // as 'intersectsWalls', for lines that end at the line point of
+    // line 'sIdx' of the cell; walls out of sight of it are left out
+    bool
+    intersectsWallsTo(smr::Line const & l                    ,
+                      IdxType           cIdx                 ,
+                      IdxType           sIdx                 ,
+                      CrdType           cpa = smr::Param::CPA) const noexcept;
+
+    bool
+    intersectsWallsTo(smr::Line          const & l                    ,
+                      IdxType                    cIdx                 ,
+                      IdxType                    sIdx                 ,
+                      std::span<IdxType const>   pseudos              ,
+                      CrdType                    cpa = smr::Param::CPA) const noexcept;
     
     std::vector<IdxType>
     linesPerCell() const;
@@ -87,6 +150,8 @@ public:
     auto const & getWallz   () const { return wallz   ; }
     auto const & getNbrz    () const { return nbrz    ; }
     auto const & getCMapR   () const { return cMapR   ; }
+    auto const & getTmplz   () const { return tmplz   ; }
+    auto const & getPermz   () const { return permz   ; }
 
     auto const & getBlob (IdxType cIdx, IdxType sIdx) const noexcept
     {
@@ -111,8 +176,10 @@ protected:
     validate() const;
 
     void patchUp          () noexcept;
+    void reorder          ()         ;
     void shrink           () noexcept;
     void constructSusoMaps()         ;
+    void formPVSs         ()         ;
 
     virtual void
     processCellExt([[ maybe_unused ]] Cell & cell)
@@ -131,7 +198,26 @@ protected:
     /* validation flag */
     bool const vFlg;
 
-    /* global counter for indexing cells */
+    /* congruence flag */
+    bool const cFlg;
+
+    // local matrix flag: the local matrices of a cell are formed
+    // right after its preparation, overlapping parsing and meshing
+    bool const mFlg;
+
+    // (re)order flag: cells are renumbered for locality ('finalize');
+    // 'cMapR' keeps their nominal indices
+    bool const oFlg;
+
+    // visible-set flag: walls out of sight of a line are left out of
+    // the tests of lines drawn to it (see 'formPVSs'); pays off with
+    // obstacles, at the cost of a pass over lines and walls per cell
+    bool const pFlg;
+
+    /* only touched by 'classifyCell' */
+    Congruence congruence;
+
+    /* global counter for indexing cells; only touched by 'processCell' */
     IdxType cellIdx {};
 
     std::unordered_set<IdxType> dummys;
@@ -167,12 +253,43 @@ protected:
 
     std::vector<std::vector<IdxType>> nbrz;
 
+    // potentially visible sets: a bit per wall, per nonsolid line, of
+    // the walls a line to its line point could touch (rows of
+    // 'pvsWords' words); empty for cells where no wall is hidden
+    std::vector<std::vector<std::uint64_t>> pvsz;
+    std::vector<IdxType>                    pvsWords;
+
+    /* clearance the sets hold for */
+    CrdType pvsCpa {};
+
+    // template of each cell (itself, unless a congruent copy), and the
+    // template column of each column of the local matrices of a copy
+    std::vector<IdxType>              tmplz;
+    std::vector<std::vector<IdxType>> permz;
+
+    /* local matrices of template cells (see 'mFlg') */
+    std::vector<std::vector<IdxType>> pathMCSs;
+    std::vector<std::vector<CrdType>> distMCSs;
+
     // map of sets of cells with non-zero parity flag wrt to
     // the key cell index (Router::formDicts)
     std::unordered_map<IdxType, std::unordered_set<IdxType>> pMaps;
+
+public:
+
+    /* thread count and block size (cells) of 'validate' */
+    static ThreadCntType constexpr NTD {   4 };
+    static IdxType       constexpr BLK { 256 };
+
+    /* slack of the (angular and clearance) bounds of 'formPVSs' */
+    static CrdType constexpr PVS_EPS { std::numeric_limits<CrdType>::epsilon() * 4096 };
 };
 
 bool
 isInsideTriangle (smr::Point const & p, TriangleType const & t) noexcept;
 
+/* reverse Cuthill-McKee order of a graph; the new index of each vertex */
+std::vector<IdxType>
+rcmOrder(std::vector<std::vector<IdxType>> const & adjz);
+
 
@@ -23,7 +23,9 @@
  * SOFTWARE.
  */
 
-#include <future>
+#include <map>
+#include <queue>
+#include <set>
 
 #include "cell.hpp"
 
@@ -54,24 +56,9 @@ Cell::addPoly(std::vector<smr::Point> && poly        ,
 std::optional<std::string>
 Cell::validate() noexcept
 {
-    for (IdxType i {}; i < polys.size(); i++)
+    for (auto const & poly : polys)
     {
-        auto ftr
-        {
-            std::async(
-                [this, i]
-                {
-                    for (IdxType j { i + 1 }; j < polys.size(); j++)
-                        if (polyIntersectionFlag(polys[i], polys[j]))
-                            return true;
-
-                    return false;
-                }
-            )
-        };
-
-        auto const & poly  { polys[i]    };
-        auto const   pSize { poly.size() };
+        auto const pSize { poly.size() };
 
         if (pSize < 3)
             return fmt::format("non-poly in cell {}", idx);
@@ -83,22 +70,18 @@ Cell::validate() noexcept
         if (fELess(lineNorm({ poly.front(), poly.back() }), smr::Param::CPA))
             return fmt::format("line norm <= smr::Param::CPA in cell {}", idx);
         
-        /* test for self-intersection */
+        /* test for self-intersection of adjacent lines */
         for (IdxType i {}; i < (pSize - 2); i++)                          /* next point not on previous line */
             if (fELess(pointLineDistance(poly[i+2], { poly[i+1], poly[i] }), smr::Param::CPA))
                 return fmt::format("a polygon intersects itself, within smr::Param::CPA, in cell {}", idx);
-        
-        for (IdxType i {}; i < (pSize - 1); i++)                  /* non-adjacent lines (except w/ last one) */
-            for (IdxType j { i + 2 }; j < (pSize - 2); j++)
-                if (intersectionFlagCPA({ poly[i], poly[i+1] }, { poly[j], poly[j+1] }))
-                    return fmt::format("a polygon intersects itself, within smr::Param::CPA, in cell {}", idx);
-        
-        smr::Line const line { poly.front(), poly.back() };                                     /* last line */
-        for (IdxType i { 1 }; i < (pSize - 2); i++)
-            if (intersectionFlagCPA({ poly[i], poly[i+1] }, line))
-                return fmt::format("a polygon intersects itself, within smr::Param::CPA, in cell {}", idx);
+    }
 
-        if (ftr.get())
+    /* non-adjacent lines, of the same or different polys */
+    if (auto const pair { sweepIntersection(polys) })
+    {
+        if (pair->first == pair->second)
+            return fmt::format("a polygon intersects itself, within smr::Param::CPA, in cell {}", idx);
+        else
             return fmt::format("polygons intersect, within smr::Param::CPA, in cell {}", idx);
     }
 
@@ -106,30 +89,114 @@ Cell::validate() noexcept
 }
 
 
-inline bool
-polyIntersectionFlag(PolyType const & polyO, PolyType const & polyS) noexcept
+/**
+ * Sorted sweep over the lines of all polys, on x-extents grown by CPA;
+ * returns the polys of the first pair of non-adjacent lines found
+ * within CPA of each other. The lines the sweep holds are ordered on
+ * their y-extents, so a line meets those within the height of the
+ * tallest held of its own, not all of them: O(n log n) for the walls
+ * of a floor, short against its span, rather than O(n^2)
+ */
+std::optional<std::pair<IdxType, IdxType>>
+sweepIntersection(std::vector<PolyType> const & polys) noexcept
 {
-    for (auto itrS { polyS.cbegin() }; itrS != (polyS.cend() - 1); itrS++)
+    struct SegType
     {
-        smr::Line const lineS { * itrS, * (itrS + 1) };
+        smr::Line line;
+
+        CrdType x0 {};  // extents, grown by CPA
+        CrdType x1 {};
+        CrdType y0 {};
+        CrdType y1 {};
 
-        for (auto itrO { polyO.cbegin() }; itrO != (polyO.cend() - 1); itrO++)
-            if (intersectionFlagCPA(lineS, { * itrO, * (itrO + 1) } ))
-                return true;
+        IdxType k {};   // poly
+        IdxType i {};   // line, within the poly
+    };
 
-        if (intersectionFlagCPA(lineS, { * (polyO.cend() - 1), * (polyO.cbegin()) } ))
-            return true;
+    auto const cpa { smr::Param::CPA };
+
+    std::vector<SegType> segs;
+    segs.reserve(std::accumulate(polys.cbegin(), polys.cend(), IdxType {},
+                                 [] (IdxType n, PolyType const & poly) { return n + poly.size(); }));
+
+    for (IdxType k {}; k < polys.size(); k++)
+    {
+        auto const & poly  { polys[k]    };
+        auto const   pSize { poly.size() };
+
+        for (IdxType i {}; i < pSize; i++)
+        {
+            auto const & u { poly[i]               };
+            auto const & v { poly[(i + 1) % pSize] };
+
+            segs.push_back({ { u, v },
+                             std::min(u.x, v.x) - cpa, std::max(u.x, v.x) + cpa,
+                             std::min(u.y, v.y) - cpa, std::max(u.y, v.y) + cpa,
+                             k, i });
+        }
     }
 
-    smr::Line const lineS { * (polyS.cend() - 1), * polyS.cbegin() };
+    std::sort(segs.begin(), segs.end(),
+              [] (SegType const & a, SegType const & b) { return a.x0 < b.x0; });
+
+    auto const adjacent
+    {
+        [& polys] (SegType const & a, SegType const & b)
+        {
+            if (a.k != b.k)
+                return false;
+
+            auto const pSize { polys[a.k].size() };
+
+            return ((a.i + 1) % pSize == b.i) or ((b.i + 1) % pSize == a.i);
+        }
+    };
+
+    /* lines whose x-extent reaches the sweep, on their lower y, with their heights */
+    std::multimap<CrdType, IdxType> actv;
+    std::multiset<CrdType>          hgts;
+
+    /* and the lines to drop, soonest first */
+    using ExpType = std::pair<CrdType, std::multimap<CrdType, IdxType>::iterator>;
 
-    for (auto itr { polyO.cbegin() }; itr != (polyO.cend() - 1); itr++)
-        if (intersectionFlagCPA(lineS, { * itr, * (itr + 1) } ))
-            return true;
+    auto const later { [] (ExpType const & a, ExpType const & b) { return a.first > b.first; } };
 
-    if (intersectionFlagCPA(lineS, { * (polyO.cend() - 1), * (polyO.cbegin()) } ))
-        return true;
+    std::priority_queue<ExpType, std::vector<ExpType>, decltype(later)> exps { later };
+
+    for (IdxType s {}; s < segs.size(); s++)
+    {
+        auto const & seg { segs[s] };
+
+        while ((not exps.empty()) and (exps.top().first < seg.x0))
+        {
+            auto const itr { exps.top().second };
 
-    return false;
+            hgts.erase(hgts.find(segs[itr->second].y1 - itr->first));
+            actv.erase(itr);
+            exps.pop();
+        }
+
+        // those reaching up to 'seg' start no lower than the tallest held
+        // reaches down (give or take CPA, for the rounding of the heights)
+        if (not actv.empty())
+        {
+            auto const bgn { actv.lower_bound(seg.y0 - * hgts.crbegin() - cpa) };
+            auto const end { actv.upper_bound(seg.y1)                          };
+
+            for (auto itr { bgn }; itr != end; itr++)
+            {
+                auto const & segA { segs[itr->second] };
+
+                if ((seg.y0 <= segA.y1) and (not adjacent(segA, seg)))
+                    if (intersectionFlagCPA(segA.line, seg.line))
+                        return std::pair { segA.k, seg.k };
+            }
+        }
+
+        exps.push({ seg.x1, actv.emplace(seg.y0, s) });
+        hgts.insert(seg.y1 - seg.y0);
+    }
+
+    return {};
 }
 
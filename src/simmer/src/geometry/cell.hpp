@@ -42,6 +42,8 @@ public:
     
     Cell(IdxType idx, bool dummy) noexcept;
 
+    Cell(Cell && src) noexcept = default;
+
     void
     addPoly(std::vector<smr::Point> && poly        ,
             std::vector<smr::Line>  && wallsMore   ,
@@ -87,7 +89,7 @@ operator+=(std::vector<T> & a, std::vector<T> const & b)
 
 using PolyType = std::vector<smr::Point>;
 
-bool
-polyIntersectionFlag(PolyType const & polyO, PolyType const & polyS) noexcept;
+std::optional<std::pair<IdxType, IdxType>>
+sweepIntersection(std::vector<PolyType> const & polys) noexcept;
 
 
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include "../support.hpp"
 
@@ -86,6 +87,11 @@ struct Param
 }  /* namespace smr */
 
 
+// edges of the refined mesh, and triangles of the
+// zeroth-order (non-recursive) mesh of a cell
+using MeshType = std::pair<std::vector<smr::Edge>, std::vector<TriangleType>>;
+
+
 inline CrdType
 lineNorm(smr::Line const & l) noexcept
 {
@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) 2022 Shahir Mowlaei
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "hierarchy.hpp"
+
+
+using QueType = std::priority_queue<NbrType, std::vector<NbrType>, std::greater<NbrType>>;
+
+
+Hierarchy::Hierarchy(GraphType const & g)
+{
+    auto const xSize { static_cast<IdxType>(g.size()) };
+
+    auto constexpr INF { std::numeric_limits<CrdType>::infinity() };
+
+    /* edges of the remaining graph: weight, and the middle vertex of a shortcut */
+    using EdgeType = std::pair<CrdType, IdxType>;
+
+    std::vector<std::unordered_map<IdxType, EdgeType>> adj(xSize);
+
+    auto const link
+    {
+        [& adj] (IdxType u, IdxType v, CrdType w, IdxType m)
+        {
+            for (auto const & [a, b] : { std::pair { u, v }, std::pair { v, u } })
+            {
+                auto const [itr, ins] { adj[a].try_emplace(b, w, m) };
+
+                if ((not ins) and (w < itr->second.first))
+                    itr->second = { w, m };
+            }
+        }
+    };
+
+    /* the weights of the two directions may differ by round-off; the least is kept */
+    for (IdxType u {}; u < xSize; u++)
+        for (auto const & [v, w] : g[u])
+            if (v != u)
+                link(u, v, w, IdxTypeMax);
+
+    std::vector<CrdType> d(xSize, INF);
+    std::vector<IdxType> seen;
+
+    // distances from 'u' in the remaining graph, less vertex 'x', up to
+    // 'lim'; bounded by 'WTN' settled vertices, so a witness may be missed
+    // (and a shortcut added in vain), but never made up
+    auto const witness
+    {
+        [& adj, & d, & seen] (IdxType u, IdxType x, CrdType lim)
+        {
+            for (auto const i : seen)
+                d[i] = INF;
+            seen.clear();
+
+            QueType q;
+
+            d[u] = 0.;
+            seen.push_back(u);
+            q.push({ 0., u });
+
+            for (IdxType cnt {}; (not q.empty()) and (cnt < WTN); )
+            {
+                auto const [du, v] { q.top() };
+                q.pop();
+
+                if (du > d[v])
+                    continue;
+
+                if (du > lim)
+                    break;
+
+                cnt++;
+
+                for (auto const & [y, e] : adj[v])
+                {
+                    if (y == x)
+                        continue;
+
+                    auto const dy { du + e.first };
+
+                    if (dy < d[y])
+                    {
+                        if (d[y] == INF)
+                            seen.push_back(y);
+
+                        d[y] = dy;
+                        q.push({ dy, y });
+                    }
+                }
+            }
+        }
+    };
+
+    /* the shortcuts that removing 'x' calls for; added if 'add', else only counted */
+    auto const contract
+    {
+        [& adj, & d, & witness, & link] (IdxType x, bool add)
+        {
+            auto const & nbrs { adj[x] };
+
+            CrdType wMax {};
+            for (auto const & [v, e] : nbrs)
+                wMax = std::max(wMax, e.first);
+
+            IdxType cnt {};
+
+            for (auto const & [u, eU] : nbrs)
+            {
+                witness(u, x, eU.first + wMax);
+
+                for (auto const & [w, eW] : nbrs)
+                {
+                    auto const via { eU.first + eW.first };
+
+                    /* each pair once; a path as short (through the rest) does */
+                    if ((w <= u) or (d[w] <= via))
+                        continue;
+
+                    cnt++;
+
+                    if (add)
+                        link(u, w, via, x);
+                }
+            }
+
+            return cnt;
+        }
+    };
+
+    // the edge difference, plus the neighbours removed already, so that
+    // the removals spread out evenly over the graph
+    std::vector<IdxType> dead(xSize);
+
+    auto const prio
+    {
+        [& adj, & dead, & contract] (IdxType x)
+        {
+            return   static_cast<std::int64_t>(contract(x, false))
+                   - static_cast<std::int64_t>(adj[x].size()     )
+                   + static_cast<std::int64_t>(dead[x]           );
+        }
+    };
+
+    using PrioType = std::pair<std::int64_t, IdxType>;
+
+    std::priority_queue<PrioType, std::vector<PrioType>, std::greater<PrioType>> pq;
+
+    for (IdxType x {}; x < xSize; x++)
+        pq.push({ prio(x), x });
+
+    std::vector<std::vector<ArcType>> upz(xSize);
+
+    rank.resize(xSize);
+    order.reserve(xSize);
+
+    while (not pq.empty())
+    {
+        auto const x { pq.top().second };
+        pq.pop();
+
+        /* lazy updates: a vertex that has grown in importance waits its turn */
+        if (auto const p { prio(x) }; (not pq.empty()) and (p > pq.top().first))
+        {
+            pq.push({ p, x });
+            continue;
+        }
+
+        contract(x, true);
+
+        for (auto const & [v, e] : adj[x])
+        {
+            upz[x].push_back({ v, e.first, e.second });
+
+            adj[v].erase(x);
+            dead[v]++;
+        }
+
+        std::unordered_map<IdxType, EdgeType> {}.swap(adj[x]);
+
+        rank[x] = static_cast<IdxType>(order.size());
+        order.push_back(x);
+    }
+
+    offs.reserve(xSize + 1);
+
+    for (auto const & up : upz)
+    {
+        offs.push_back(static_cast<IdxType>(arcs.size()));
+        arcs.insert(arcs.end(), up.cbegin(), up.cend());
+    }
+    offs.push_back(static_cast<IdxType>(arcs.size()));
+
+    formLabels();
+}
+
+
+Hierarchy::ArcType const &
+Hierarchy::arc(IdxType u, IdxType v) const noexcept
+{
+    if (rank[v] < rank[u])
+        std::swap(u, v);
+
+    auto const up { ups(u) };
+
+    return * std::find_if(up.begin(), up.end(), [v] (auto const & a) { return a.v == v; });
+}
+
+
+void
+Hierarchy::formLabels()
+{
+    auto const xSize { size() };
+
+    std::vector<std::vector<HubType>> lbls(xSize);
+
+    // the label of a vertex is its upward search space, less the vertices
+    // the search stalls on; the searches are independent
+    spawnBlocks(NTD, xSize, BLK,
+        [this, xSize, & lbls] (IdxType bgn, IdxType end)
+        {
+            std::vector<CrdType> d(xSize, std::numeric_limits<CrdType>::infinity());
+            std::vector<IdxType> p(xSize, IdxTypeMax);
+            std::vector<IdxType> seen;
+
+            QueType q;
+
+            for (IdxType s { bgn }; s < end; s++)
+            {
+                for (auto const i : seen)
+                {
+                    d[i] = std::numeric_limits<CrdType>::infinity();
+                    p[i] = IdxTypeMax;
+                }
+                seen.clear();
+
+                d[s] = 0.;
+                p[s] = s ;
+
+                seen.push_back(s);
+                q.push({ 0., s });
+
+                auto & lbl { lbls[s] };
+
+                while (not q.empty())
+                {
+                    auto const [du, u] { q.top() };
+                    q.pop();
+
+                    if (du > d[u])
+                        continue;
+
+                    // stall-on-demand: a vertex reached shorter from above
+                    // (by the search, yet to settle it) is off the shortest
+                    // paths that climb through it
+                    auto const up { ups(u) };
+
+                    if (std::any_of(up.begin(), up.end(), [& d, du] (auto const & a) { return d[a.v] + a.w < du; }))
+                        continue;
+
+                    lbl.push_back({ u, du, p[u] });
+
+                    for (auto const & a : up)
+                        if (auto const dv { du + a.w }; dv < d[a.v])
+                        {
+                            d[a.v] = dv;
+                            p[a.v] = u ;
+
+                            seen.push_back(a.v);
+                            q.push({ dv, a.v });
+                        }
+                }
+
+                std::sort(lbl.begin(), lbl.end(), [] (auto const & a, auto const & b) { return a.h < b.h; });
+            }
+        });
+
+    lOffs.reserve(xSize + 1);
+
+    for (auto & lbl : lbls)
+    {
+        lOffs.push_back(static_cast<IdxType>(hubs.size()));
+        hubs.insert(hubs.end(), lbl.cbegin(), lbl.cend());
+
+        std::vector<HubType> {}.swap(lbl);
+    }
+    lOffs.push_back(static_cast<IdxType>(hubs.size()));
+}
+
+
+Hierarchy::HubType const &
+Hierarchy::hub(IdxType u, IdxType h) const noexcept
+{
+    auto const lbl { label(u) };
+
+    return * std::lower_bound(lbl.begin(), lbl.end(), h, [] (auto const & a, IdxType h) { return a.h < h; });
+}
+
+
+std::pair<IdxType, CrdType>
+Hierarchy::meet(IdxType s, IdxType t) const noexcept
+{
+    auto const lblS { label(s) };
+    auto const lblT { label(t) };
+
+    IdxType mid  { IdxTypeMax                                };
+    CrdType best { std::numeric_limits<CrdType>::infinity() };
+
+    /* both labels are sorted by hub */
+    for (auto itrS { lblS.begin() }, itrT { lblT.begin() }; (itrS != lblS.end()) and (itrT != lblT.end()); )
+    {
+        if (itrS->h < itrT->h)
+            itrS++;
+        else if (itrT->h < itrS->h)
+            itrT++;
+        else
+        {
+            if (auto const dst { itrS->d + itrT->d }; dst < best)
+            {
+                best = dst;
+                mid  = itrS->h;
+            }
+
+            itrS++;
+            itrT++;
+        }
+    }
+
+    return { mid, best };
+}
+
+
+CrdType
+Hierarchy::distance(IdxType s, IdxType t) const
+{
+    return meet(s, t).second;
+}
+
+
+IdxType
+Hierarchy::nextHop(IdxType s, IdxType t) const
+{
+    if (s == t)
+        return s;
+
+    auto const mid { meet(s, t).first };
+
+    if (mid == IdxTypeMax)
+        return IdxTypeMax;
+
+    // the first arc of the path: up from 's' towards 'mid', back along the
+    // parents in the label of 's', or (if 's' is the top) down towards
+    // 't'; its shortcuts then unpack to an edge
+    IdxType v { mid };
+
+    if (mid == s)
+        v = hub(t, s).p;
+    else
+        while (hub(s, v).p != s)
+            v = hub(s, v).p;
+
+    for (auto m { arc(s, v).m }; m != IdxTypeMax; m = arc(s, v).m)
+        v = m;
+
+    return v;
+}
+
+
+void
+Hierarchy::sweep(std::span<IdxType const>   srcs,
+                 std::vector<CrdType>     & dist,
+                 std::vector<IdxType>     * near) const
+{
+    dist.assign(size(), std::numeric_limits<CrdType>::infinity());
+
+    if (near)
+        near->assign(size(), IdxTypeMax);
+
+    QueType q;
+
+    for (auto const s : srcs)
+    {
+        dist[s] = 0.;
+
+        if (near)
+            (* near)[s] = s;
+
+        q.push({ 0., s });
+    }
+
+    /* up from the sources .. */
+    while (not q.empty())
+    {
+        auto const [du, u] { q.top() };
+        q.pop();
+
+        if (du > dist[u])
+            continue;
+
+        for (auto const & a : ups(u))
+            if (auto const dv { du + a.w }; dv < dist[a.v])
+            {
+                dist[a.v] = dv;
+
+                if (near)
+                    (* near)[a.v] = (* near)[u];
+
+                q.push({ dv, a.v });
+            }
+    }
+
+    /* .. and down the ranks, each vertex off its higher-ranked neighbours */
+    for (auto r { size() }; r-- > 0; )
+    {
+        auto const u { order[r] };
+
+        for (auto const & a : ups(u))
+            if (auto const du { dist[a.v] + a.w }; du < dist[u])
+            {
+                dist[u] = du;
+
+                if (near)
+                    (* near)[u] = (* near)[a.v];
+            }
+    }
+}
+
+
+std::size_t
+Hierarchy::footprint() const noexcept
+{
+    return (rank.capacity() + order.capacity() + offs.capacity() + lOffs.capacity()) * sizeof(IdxType)
+         + arcs.capacity() * sizeof(ArcType) + hubs.capacity() * sizeof(HubType);
+}
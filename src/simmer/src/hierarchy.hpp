@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2022 Shahir Mowlaei
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <span>
+
+#include "finder.hpp"
+
+
+/**
+ * Contraction hierarchy over an (undirected) graph: vertices are removed
+ * one at a time, least important first, with shortcuts that keep the
+ * distances of the rest; a shortest path then climbs from either end to
+ * a common vertex. The climbs are done ahead, once per vertex, into hub
+ * labels, so that a query merges two short sorted lists
+ */
+class Hierarchy
+{
+public:
+
+    Hierarchy() = default;
+
+    explicit Hierarchy(GraphType const & g);
+
+    /* infinity if 't' cannot be reached from 's'; the queries are reentrant */
+    CrdType
+    distance(IdxType s, IdxType t) const;
+
+    /* the vertex next to 's' on a shortest path to 't'; 'IdxTypeMax' if none */
+    IdxType
+    nextHop(IdxType s, IdxType t) const;
+
+    // distances of all vertices to the nearest of 'srcs', and that source
+    // if 'near' is given; one upward search and a sweep down the ranks
+    void
+    sweep(std::span<IdxType const>   srcs          ,
+          std::vector<CrdType>     & dist          ,
+          std::vector<IdxType>     * near = nullptr) const;
+
+    IdxType size() const noexcept { return static_cast<IdxType>(rank.size()); }
+
+    /* approximate heap footprint, in bytes */
+    std::size_t
+    footprint() const noexcept;
+
+protected:
+
+    /* an arc to a higher-ranked vertex; 'm' is the middle vertex of a shortcut */
+    struct ArcType
+    {
+        IdxType v {};
+        CrdType w {};
+        IdxType m { IdxTypeMax };
+    };
+
+    std::span<ArcType const>
+    ups(IdxType u) const noexcept { return { arcs.data() + offs[u], arcs.data() + offs[u + 1] }; }
+
+    /* the arc between two vertices, off the lower-ranked one */
+    ArcType const &
+    arc(IdxType u, IdxType v) const noexcept;
+
+    /* a hub of a label, its distance, and the vertex before it on the way up */
+    struct HubType
+    {
+        IdxType h {};
+        CrdType d {};
+        IdxType p {};
+    };
+
+    std::span<HubType const>
+    label(IdxType u) const noexcept { return { hubs.data() + lOffs[u], hubs.data() + lOffs[u + 1] }; }
+
+    /* the entry of hub 'h' in the label of 'u' (which must hold it) */
+    HubType const &
+    hub(IdxType u, IdxType h) const noexcept;
+
+    /* the common hub of 's' and 't' closest to both (or 'IdxTypeMax'), and the distance */
+    std::pair<IdxType, CrdType>
+    meet(IdxType s, IdxType t) const noexcept;
+
+    void
+    formLabels();
+
+    std::vector<IdxType> rank ;
+    std::vector<IdxType> order;  /* vertices, by rank */
+
+    /* upward arcs of vertex 'u' take up [offs[u], offs[u+1]) */
+    std::vector<IdxType> offs;
+    std::vector<ArcType> arcs;
+
+    /* the label of vertex 'u' takes up [lOffs[u], lOffs[u+1]), by hub */
+    std::vector<IdxType> lOffs;
+    std::vector<HubType> hubs ;
+
+public:
+
+    /* vertices settled by a witness search before it gives up */
+    static IdxType constexpr WTN { 64 };
+
+    /* thread count and block size (vertices) of the labelling */
+    static ThreadCntType constexpr NTD {  4 };
+    static IdxType       constexpr BLK { 32 };
+};
+
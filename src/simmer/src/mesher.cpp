@@ -26,71 +26,67 @@
 #include "mesher.hpp"
 
 
-std::vector<smr::Edge>
+MeshType
 Mesher::mesh(std::vector<std::vector<smr::Point>> const & polys) const
 {
     std::vector<CDT::V2d<CrdType>> vrt;
     std::vector<CDT::Edge>         edg;
 
-    CDT::VertInd xCnt {};
-    CDT::VertInd yCnt {};
-    
-    for (auto const & poly : polys)
-    {
-        for (auto itr { poly.cbegin() }; itr != poly.cend(); itr++)
-        {
-            CDT::V2d<CrdType> v { itr -> x, itr -> y };
-            vrt.push_back(v);
+    polysToCDT(polys, vrt, edg);
 
-            if ((itr + 1) != poly.cend())
-            {
-                CDT::Edge e { yCnt, yCnt + 1 };
-                edg.push_back(e);
-            }
-            else
-            {
-                CDT::Edge e { yCnt, xCnt };
-                edg.push_back(e);
-            }
-
-            yCnt++;
-        }
+    /* the constraint edges are fixed throughout refinement */
+    ClearanceGrid const grd { rfn and (rfn->lfs > 0) ? ClearanceGrid { vrt, edg } : ClearanceGrid {} };
 
-        xCnt = yCnt;
-    }
+    /* one triangulation, refined in place: the super-triangle is kept
+       until the last level so that new vertices can be inserted */
+    CDT::Triangulation<CrdType> cdt;
 
-    /* first triangulation */
-    auto [vrtT, triVec] { triangulateVCT(vrt, edg) };
+    cdt.insertVertices(vrt);
+    cdt.insertEdges(edg);
 
-    /* extract vertices */
-    vrt = std::move(vrtT);
+    auto inr { interiorTriangles(cdt) };
 
-    /* set 'tris' AND 'trisFlg' */
-    tris.clear();
-    tris.reserve(triVec.size());
+    std::vector<TriangleType> tris;
+    tris.reserve(cdt.triangles.size());
 
-    for (auto const & t : triVec)
+    for (IdxType i {}; i < cdt.triangles.size(); i++)
     {
-        auto const & u { vrt[t.vertices[0]] };
-        auto const & v { vrt[t.vertices[1]] };
-        auto const & w { vrt[t.vertices[2]] };
+        if (not inr[i])
+            continue;
+        
+        auto const & t { cdt.triangles[i] };
 
+        auto const & u { cdt.vertices[t.vertices[0]] };
+        auto const & v { cdt.vertices[t.vertices[1]] };
+        auto const & w { cdt.vertices[t.vertices[2]] };
+        
         tris.emplace_back(TriangleType { { u.x, u.y }, { v.x, v.y }, { w.x, w.y } });
     }
 
-    trisFlg = true;
-
-    /* recurse for positive 'spt' */
-    if (spt)
+    /* insert the centroids of the interior triangles, level by level */
+    for (IdxType i { spt }; i; i--)
     {
-        /* all but the last recursion */
-        for (IdxType i { spt - 1 }; i; i--)
-            vrt = triangulateVC(vrt, edg);
+        if (i != spt)
+            inr = interiorTriangles(cdt);
 
-        /* last recursion */
-        triVec = triangulateT(vrt, edg);
+        vrt.clear();
+        
+        for (IdxType j {}; j < cdt.triangles.size(); j++)
+            if (inr[j] and ((not rfn) or refine(cdt, cdt.triangles[j], grd)))
+                vrt.emplace_back(centroid(cdt, cdt.triangles[j]));
+
+        /* adaptive mode converged */
+        if (vrt.empty())
+            break;
+        
+        cdt.insertVertices(vrt);
     }
 
+    cdt.eraseOuterTrianglesAndHoles();
+
+    auto const & triVec { cdt.triangles };
+    auto const & vrtc   { cdt.vertices  };
+
     std::vector<smr::Edge> edges;
     edges.reserve(3 * triVec.size());
 
@@ -98,9 +94,9 @@ Mesher::mesh(std::vector<std::vector<smr::Point>> const & polys) const
     {
         auto const & t { triVec[i] };
 
-        auto const & u { vrt[t.vertices[0]] };
-        auto const & v { vrt[t.vertices[1]] };
-        auto const & w { vrt[t.vertices[2]] };
+        auto const & u { vrtc[t.vertices[0]] };
+        auto const & v { vrtc[t.vertices[1]] };
+        auto const & w { vrtc[t.vertices[2]] };
 
         smr::Point const up { u.x, u.y };
         smr::Point const vp { v.x, v.y };
@@ -122,19 +118,60 @@ Mesher::mesh(std::vector<std::vector<smr::Point>> const & polys) const
 
     edges.shrink_to_fit();
 
-    return edges;
+    return { std::move(edges), std::move(tris) };
+}
+
+
+bool
+Mesher::refine(CDT::Triangulation<CrdType> const & cdt,
+               CDT::Triangle               const & t  ,
+               ClearanceGrid               const & grd) const
+{
+    auto const & u { cdt.vertices[t.vertices[0]] };
+    auto const & v { cdt.vertices[t.vertices[1]] };
+    auto const & w { cdt.vertices[t.vertices[2]] };
+
+    auto const luv { CDT::distance(u, v) };
+    auto const lvw { CDT::distance(v, w) };
+    auto const lwu { CDT::distance(w, u) };
+
+    auto const lM { std::max({ luv, lvw, lwu }) };
+
+    if ((rfn->len > 0) and (lM > rfn->len))
+        return true;
+
+    if (rfn->are > 0)
+    {
+        auto const are { std::fabs((v.x - u.x) * (w.y - u.y) - (w.x - u.x) * (v.y - u.y)) / 2 };
+
+        if (are > rfn->are)
+            return true;
+    }
+
+    if (rfn->lfs > 0)
+        return lM > rfn->lfs * grd.clearance(centroid(cdt, t));
+
+    return false;
 }
 
 
 std::vector<TriangleType>
 Mesher::zerothOrderTriangles(std::vector<std::vector<smr::Point>> const & polys) const
 {
-    if (trisFlg)
-        return tris;
-    
     std::vector<CDT::V2d<CrdType>> vrt;
     std::vector<CDT::Edge>         edg;
 
+    polysToCDT(polys, vrt, edg);
+
+    return cdtToTriangles(vrt, triangulateT(vrt, edg));
+}
+
+
+void
+polysToCDT(std::vector<std::vector<smr::Point>> const & polys,
+           std::vector<CDT::V2d<CrdType>>             & vrt  ,
+           std::vector<CDT::Edge>                     & edg  )
+{
     CDT::VertInd xCnt {};
     CDT::VertInd yCnt {};
     
@@ -161,10 +198,13 @@ Mesher::zerothOrderTriangles(std::vector<std::vector<smr::Point>> const & polys)
 
         xCnt = yCnt;
     }
+}
 
-    auto const triVec { triangulateT(vrt, edg) };
 
-    tris.clear();
+std::vector<TriangleType>
+cdtToTriangles(std::vector<CDT::V2d<CrdType>> const & vrt, CDT::TriangleVec const & triVec)
+{
+    std::vector<TriangleType> tris;
     tris.reserve(triVec.size());
 
     for (auto const & t : triVec)
@@ -193,65 +233,161 @@ triangulateT(std::vector<CDT::V2d<CrdType>> & vrt, std::vector<CDT::Edge> & edg)
 }
 
 
-std::vector<CDT::V2d<CrdType>>
-triangulateVC(std::vector<CDT::V2d<CrdType>> & vrt, std::vector<CDT::Edge> & edg)
+std::vector<bool>
+interiorTriangles(CDT::Triangulation<CrdType> const & cdt)
 {
-    CDT::Triangulation<CrdType> cdt;
+    /* odd depth: inside a boundary but not within a hole, mirroring
+       what 'eraseOuterTrianglesAndHoles' keeps */
+    auto const dpt { CDT::CalculateTriangleDepths(cdt.vertTris[0].front(),
+                                                  cdt.triangles,
+                                                  cdt.fixedEdges,
+                                                  cdt.overlapCount) };
+    std::vector<bool> inr(dpt.size());
+
+    for (IdxType i {}; i < dpt.size(); i++)
+        inr[i] = dpt[i] % 2;
+
+    return inr;
+}
+
+
+CDT::V2d<CrdType>
+centroid(CDT::Triangulation<CrdType> const & cdt, CDT::Triangle const & t)
+{
+    auto const & u { cdt.vertices[t.vertices[0]] };
+    auto const & v { cdt.vertices[t.vertices[1]] };
+    auto const & w { cdt.vertices[t.vertices[2]] };
+
+    auto const vwx { std::midpoint(v.x, w.x) };
+    auto const vwy { std::midpoint(v.y, w.y) };
+
+    auto const cx { std::lerp(u.x, vwx, 2. / 3) };
+    auto const cy { std::lerp(u.y, vwy, 2. / 3) };
     
-    cdt.insertVertices(vrt);
-    cdt.insertEdges(edg);
-    cdt.eraseOuterTrianglesAndHoles();
+    return { static_cast<CrdType>(cx), static_cast<CrdType>(cy) };
+}
 
-    auto const triVec { cdt.triangles };
-    auto       vrtc   { cdt.vertices  };
 
-    for (auto const & t : triVec)
+ClearanceGrid::ClearanceGrid(std::vector<CDT::V2d<CrdType>> const & vrt, std::vector<CDT::Edge> const & edg)
+{
+    if (vrt.empty() or edg.empty())
+        return;
+
+    auto xMx { vrt.front().x }, yMx { vrt.front().y };
+
+    xMn = xMx;
+    yMn = yMx;
+
+    for (auto const & v : vrt)
     {
-        auto const & u { vrt[t.vertices[0]] };
-        auto const & v { vrt[t.vertices[1]] };
-        auto const & w { vrt[t.vertices[2]] };
+        xMn = std::min(xMn, v.x);
+        yMn = std::min(yMn, v.y);
+        xMx = std::max(xMx, v.x);
+        yMx = std::max(yMx, v.y);
+    }
 
-        auto const vwx { std::midpoint(v.x, w.x) };
-        auto const vwy { std::midpoint(v.y, w.y) };
+    /* about one bucket per edge */
+    auto const dim { static_cast<CrdType>(std::ceil(std::sqrt(static_cast<double>(edg.size())))) };
+    
+    sz = std::max(xMx - xMn, yMx - yMn) / dim;
+
+    if (not (sz > 0))
+        sz = 1;
+
+    nX = static_cast<IdxType>((xMx - xMn) / sz) + 1;
+    nY = static_cast<IdxType>((yMx - yMn) / sz) + 1;
+
+    bkts.resize(nX * nY);
+    lins.reserve(edg.size());
 
-        auto const cx { std::lerp(u.x, vwx, 2. / 3) };
-        auto const cy { std::lerp(u.y, vwy, 2. / 3) };
+    for (auto const & e : edg)
+    {
+        auto const & u { vrt[e.v1()] };
+        auto const & v { vrt[e.v2()] };
+
+        auto const idx { static_cast<IdxType>(lins.size()) };
         
-        vrtc.emplace_back(CDT::V2d<CrdType> { static_cast<CrdType>(cx), static_cast<CrdType>(cy) });
+        lins.push_back({ { u.x, u.y }, { v.x, v.y } });
+
+        /* the buckets of its bounding box */
+        for (auto j { bktY(std::min(u.y, v.y)) }; j <= bktY(std::max(u.y, v.y)); j++)
+            for (auto i { bktX(std::min(u.x, v.x)) }; i <= bktX(std::max(u.x, v.x)); i++)
+                bkts[j * nX + i].push_back(idx);
     }
+}
+
+
+IdxType
+ClearanceGrid::bktX(CrdType x) const noexcept
+{
+    if (x <= xMn)
+        return 0;
     
-    return vrtc;
+    return std::min(static_cast<IdxType>((x - xMn) / sz), nX - 1);
 }
 
 
-std::pair<std::vector<CDT::V2d<CrdType>>, CDT::TriangleVec>
-triangulateVCT(std::vector<CDT::V2d<CrdType>> & vrt, std::vector<CDT::Edge> & edg)
+IdxType
+ClearanceGrid::bktY(CrdType y) const noexcept
 {
-    CDT::Triangulation<CrdType> cdt;
+    if (y <= yMn)
+        return 0;
     
-    cdt.insertVertices(vrt);
-    cdt.insertEdges(edg);
-    cdt.eraseOuterTrianglesAndHoles();
+    return std::min(static_cast<IdxType>((y - yMn) / sz), nY - 1);
+}
 
-    auto const triVec { cdt.triangles };
-    auto       vrtc   { cdt.vertices  };
 
-    for (auto const & t : triVec)
-    {
-        auto const & u { vrt[t.vertices[0]] };
-        auto const & v { vrt[t.vertices[1]] };
-        auto const & w { vrt[t.vertices[2]] };
+CrdType
+ClearanceGrid::clearance(CDT::V2d<CrdType> const & p) const
+{
+    auto clr { std::numeric_limits<CrdType>::max() };
+
+    if (bkts.empty())
+        return clr;
 
-        auto const vwx { std::midpoint(v.x, w.x) };
-        auto const vwy { std::midpoint(v.y, w.y) };
+    auto const cX { static_cast<long long>(bktX(p.x)) };
+    auto const cY { static_cast<long long>(bktY(p.y)) };
+    auto const mX { static_cast<long long>(nX) };
+    auto const mY { static_cast<long long>(nY) };
 
-        auto const cx { std::lerp(u.x, vwx, 2. / 3) };
-        auto const cy { std::lerp(u.y, vwy, 2. / 3) };
+    auto const scan
+    {
+        [this, & p, & clr, mX, mY] (long long i, long long j)
+        {
+            if ((i < 0) or (j < 0) or (i >= mX) or (j >= mY))
+                return;
         
-        vrtc.emplace_back(CDT::V2d<CrdType> { static_cast<CrdType>(cx), static_cast<CrdType>(cy) });
+            for (auto const idx : bkts[j * mX + i])
+                clr = std::min(clr, pointLineDistance({ p.x, p.y }, lins[idx]));
+        }
+    };
+
+    /* ring 'r' holds the buckets at Chebyshev distance 'r'; those
+       beyond it lie at least 'r * sz' away from 'p' */
+    for (long long r {}; r <= std::max(mX, mY); r++)
+    {
+        if (not r)
+            scan(cX, cY);
+        else
+        {
+            for (auto i { cX - r }; i <= cX + r; i++)
+            {
+                scan(i, cY - r);
+                scan(i, cY + r);
+            }
+
+            for (auto j { cY - r + 1 }; j < cY + r; j++)
+            {
+                scan(cX - r, j);
+                scan(cX + r, j);
+            }
+        }
+
+        if (clr <= r * sz)
+            break;
     }
-    
-    return { vrtc, triVec };
+
+    return clr;
 }
 
 
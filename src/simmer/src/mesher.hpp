@@ -25,11 +25,63 @@
 
 #pragma once
 
+#include <optional>
+
 #include "CDT.h"
 
 #include "geometry/line.hpp"
 
 
+/*
+ * criteria of the adaptive refinement mode;
+ * a triangle is refined if any criterion holds,
+ * and a zero disables the respective criterion
+ */
+struct RefineType
+{
+    CrdType len {};  // longest edge is longer than 'len'
+    CrdType are {};  // area is larger than 'are'
+
+    // longest edge is longer than 'lfs' times the clearance of
+    // the centroid from the cell boundary and the obstacles;
+    // grades the mesh towards walls and narrow passages
+    CrdType lfs {};
+};
+
+
+/*
+ * uniform grid over the constraint edges of a cell,
+ * built once per cell, for nearest-edge queries of
+ * the 'lfs' criterion; a query only scans buckets
+ * in rings around the query point until no closer
+ * edge can remain
+ */
+class ClearanceGrid
+{
+public:
+
+    ClearanceGrid() = default;
+
+    ClearanceGrid(std::vector<CDT::V2d<CrdType>> const & vrt, std::vector<CDT::Edge> const & edg);
+
+    CrdType
+    clearance(CDT::V2d<CrdType> const & p) const;
+
+private:
+
+    std::vector<smr::Line> lins;
+    
+    /* edge indices per bucket, row-major */
+    std::vector<std::vector<IdxType>> bkts;
+
+    CrdType xMn {}, yMn {}, sz { 1 };
+    IdxType nX  {}, nY  {};
+
+    IdxType bktX(CrdType x) const noexcept;
+    IdxType bktY(CrdType y) const noexcept;
+};
+
+
 class Mesher
 {
 public:
@@ -40,8 +92,11 @@ public:
     explicit
     Mesher(IdxType spt) noexcept : spt { spt } {};
 
+    /* adaptive mode: at most 'spt' levels, refining by 'rfn' */
+    Mesher(IdxType spt, RefineType const & rfn) noexcept : spt { spt }, rfn { rfn } {};
+
     virtual
-    std::vector<smr::Edge>
+    MeshType
     mesh(std::vector<std::vector<smr::Point>> const & polys) const;
         
     std::vector<TriangleType>
@@ -49,21 +104,40 @@ public:
     
 protected:
 
+    /* whether an interior triangle is refined in adaptive mode */
+    virtual
+    bool
+    refine(CDT::Triangulation<CrdType> const & cdt,
+           CDT::Triangle               const & t  ,
+           ClearanceGrid               const & grd) const;
+
+    // no mutable state: 'mesh' and 'zerothOrderTriangles' are safe
+    // to call concurrently on a shared instance (see 'Parser')
     IdxType const spt;
 
-    mutable std::vector<TriangleType> tris {};
-    
-    mutable bool trisFlg {};
+    /* uniform refinement if empty */
+    std::optional<RefineType> const rfn;
+
+public:
 
+    /* grading only; about a fifth of the lines of a uniform 'spt' of 4 */
+    static RefineType constexpr RFN { 0., 0., 4. };
 };
 
 
+void
+polysToCDT(std::vector<std::vector<smr::Point>> const & polys,
+           std::vector<CDT::V2d<CrdType>>             & vrt  ,
+           std::vector<CDT::Edge>                     & edg  );
+
+std::vector<TriangleType>
+cdtToTriangles(std::vector<CDT::V2d<CrdType>> const & vrt, CDT::TriangleVec const & triVec);
+
 CDT::TriangleVec
 triangulateT(std::vector<CDT::V2d<CrdType>> & vrt, std::vector<CDT::Edge> & edg);
 
-std::vector<CDT::V2d<CrdType>>
-triangulateVC(std::vector<CDT::V2d<CrdType>> & vrt, std::vector<CDT::Edge> & edg);
-
-std::pair<std::vector<CDT::V2d<CrdType>>, CDT::TriangleVec>
-triangulateVCT(std::vector<CDT::V2d<CrdType>> & vrt, std::vector<CDT::Edge> & edg);
+std::vector<bool>
+interiorTriangles(CDT::Triangulation<CrdType> const & cdt);
 
+CDT::V2d<CrdType>
+centroid(CDT::Triangulation<CrdType> const & cdt, CDT::Triangle const & t);
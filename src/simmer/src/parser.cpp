@@ -23,7 +23,8 @@
  * SOFTWARE.
  */
 
-#include <future>
+#include <condition_variable>
+#include <map>
 
 #include "geometry.hpp"
 #include "partition.hpp"
@@ -32,11 +33,13 @@
 
 Parser::Parser(std::filesystem::path const & geomPath ,
                Geometry                    & geometry ,
-               Partition             const & partition) noexcept
+               Partition             const & partition,
+               ThreadCntType                 ntd      ) noexcept
 
-    : geomPath  { geomPath  },
-      geometry  { geometry  },
-      partition { partition }
+    : geomPath  { geomPath         },
+      geometry  { geometry         },
+      partition { partition        },
+      ntd       { std::max(ntd, 1u) }
 {}
 
 
@@ -66,36 +69,115 @@ Parser::parsePartition(pugi::xml_node const & xPartition) const
     auto const cellS    { partition.cell()    };
     auto const idxS     { partition.idx()     };
     auto const dummyS   { partition.dummy()   };
-    auto const polygonS { partition.polygon() };
-    auto const pointS   { partition.point()   };
-    auto const xCordS   { partition.xCord()   };
-    auto const yCordS   { partition.yCord()   };
-    auto const lineCTS  { partition.lineCT()  };
-    auto const sIdxS    { partition.sIdx()    };
-    auto const cIdxS    { partition.cIdx()    };
-    auto const oIdxS    { partition.oIdx()    };
-    auto const parityS  { partition.parity()  };
-    
-    auto const infcColor { static_cast<LCType>(LineColor::INFC) };
-    auto const exitColor { static_cast<LCType>(LineColor::EXIT) };
-    auto const soldColor { static_cast<LCType>(LineColor::SOLD) };
-    auto const invdColor { static_cast<LCType>(LineColor::INVD) };
 
     std::unordered_set<IdxType> cellIds;
 
-    /* initialize 'ftr' */
-    auto ftr { std::async([] ([[ maybe_unused ]] Cell && cell) -> std::optional<std::string> { return {}; }, Cell { {}, {} }) };
-    
+    // cells flow through a bounded pipeline:
+    //   1. this thread reads cells off the partition and classifies them (in order)
+    //   2. 'ntd' workers prepare them (validate, mesh, index), in any order
+    //   3. this thread commits them to 'Geometry' in read order
+    using ItemType = std::tuple<Cell, Geometry::CellDataType, std::optional<std::string>>;
+
+    std::queue<std::tuple<IdxType, Cell, Geometry::CellDataType>> que;  // read, pending preparation
+    std::map<IdxType, ItemType>                                   rdy;  // prepared, pending commit
+
+    std::mutex              mu;
+    std::condition_variable cvW;               // signals workers
+    std::condition_variable cvC;               // signals the committer
+
+    bool halt {};
+
+    IdxType seqR {};  // cells read
+    IdxType seqC {};  // cells committed
+
+    auto const worker
+    {
+        [this, & que, & rdy, & mu, & cvW, & cvC, & halt]
+        {
+            std::unique_lock lock { mu };
+
+            while (true)
+            {
+                cvW.wait(lock, [& que, & halt] { return halt or (not que.empty()); });
+
+                if (que.empty())
+                    return;
+
+                auto [seq, cell, data] { std::move(que.front()) };
+                que.pop();
+
+                lock.unlock();
+
+                auto err { geometry.prepareCell(cell, data) };
+
+                lock.lock();
+
+                rdy.emplace(seq, ItemType { std::move(cell), std::move(data), std::move(err) });
+                cvC.notify_one();
+            }
+        }
+    };
+
+    /* commits in order until at most 'bnd' cells are in flight */
+    auto const commit
+    {
+        [this, & rdy, & mu, & cvC, & seqR, & seqC] (IdxType bnd) -> std::optional<std::string>
+        {
+            std::unique_lock lock { mu };
+
+            while (seqC < seqR)
+            {
+                if (not rdy.contains(seqC))
+                {
+                    if ((seqR - seqC) <= bnd)
+                        break;
+
+                    cvC.wait(lock, [& rdy, & seqC] { return rdy.contains(seqC); });
+                }
+
+                auto node { rdy.extract(seqC) };
+
+                lock.unlock();
+
+                auto & [cell, data, err] { node.mapped() };
+
+                if (err)
+                    return err.value();
+
+                if (auto const errC { geometry.processCell(std::move(cell), std::move(data)) })
+                    return errC.value();
+
+                lock.lock();
+
+                seqC++;
+            }
+
+            return {};
+        }
+    };
+
+    std::vector<std::thread> tds;
+    for (ThreadCntType i {}; i < ntd; i++)
+        tds.emplace_back(std::thread { worker });
+
+    std::optional<std::string> err;
+
     for (auto xCell { xPartition.child(cellS) };
          xCell;
          xCell = xCell.next_sibling(cellS)     )
     {
         auto const cellIdx { xAsIdxType(xCell.attribute(idxS).value()) };
         if (not cellIdx)
-            return fmt::format("invalid cell index ({}) encountered; expected positive", cellIdx);
+        {
+            err = fmt::format("invalid cell index ({}) encountered; expected positive", cellIdx);
+            break;
+        }
 
         if (cellIds.contains(cellIdx))
-            return fmt::format("duplicate cell index ({}) encountered; expected unique", cellIdx);
+        {
+            err = fmt::format("duplicate cell index ({}) encountered; expected unique", cellIdx);
+            break;
+        }
         else
             cellIds.insert(cellIdx);
         
@@ -103,122 +185,161 @@ Parser::parsePartition(pugi::xml_node const & xPartition) const
         
         Cell cell { cellIdx, dummy };
 
-        // - the first poly should be the one enclosing/defining the cell;
-        //   all subsequent polys should be obstacles within it.
-        //   assuming CCW orientation, DT should be done here so that meta-lines
-        //   are added to (the cell and) the router in their
-        //   proper (memory) locality.
-        // - inner polys (obstacles) shall not intersect with the outer (first)
-        //   poly, and with each other; otherwise triangulators may fail (CGAL, eg.).
-        //   this is not a limitation, only a restriction.
-        // - inner polys shall not contain (completing) metalines.
-        for (auto xPolygons { xCell.child(polygonS) };
-             xPolygons;
-             xPolygons = xPolygons.next_sibling(polygonS))
+        if ((err = parseCell(xCell, cell)))
+            break;
+
+        if ((err = parseCellExt(xCell, partition)))
+            break;
+
+        Geometry::CellDataType data;
+        geometry.classifyCell(cell, data);
+
         {
-            std::vector<smr::Point> poly;
-            std::vector<smr::Line>  walls;
-            std::vector<smr::Line>  susos;
-            std::vector<TriType>    susoExts;
-            std::vector<BlobType>   blobs;
+            std::unique_lock const lock { mu };
+            que.emplace(seqR++, std::move(cell), std::move(data));
+        }
+        cvW.notify_one();
+
+        if ((err = commit(BND * ntd)))
+            break;
+    }
+
+    if (not err)
+        err = commit(0);
+
+    {
+        std::unique_lock const lock { mu };
+        que  = {};
+        halt = true;
+    }
+    cvW.notify_all();
+
+    for (auto & td : tds)
+        td.join();
+
+    return err;
+}
+
+
+std::optional<std::string>
+Parser::parseCell(pugi::xml_node const & xCell, Cell & cell) const
+{
+    /* types employed from the 'Partition' class */
+    auto const polygonS { partition.polygon() };
+    auto const pointS   { partition.point()   };
+    auto const xCordS   { partition.xCord()   };
+    auto const yCordS   { partition.yCord()   };
+    auto const lineCTS  { partition.lineCT()  };
+    auto const sIdxS    { partition.sIdx()    };
+    auto const cIdxS    { partition.cIdx()    };
+    auto const oIdxS    { partition.oIdx()    };
+    auto const parityS  { partition.parity()  };
+    
+    auto const infcColor { static_cast<LCType>(LineColor::INFC) };
+    auto const exitColor { static_cast<LCType>(LineColor::EXIT) };
+    auto const soldColor { static_cast<LCType>(LineColor::SOLD) };
+    auto const invdColor { static_cast<LCType>(LineColor::INVD) };
+
+    auto const cellIdx { cell.getIdx() };
+
+    // - the first poly should be the one enclosing/defining the cell;
+    //   all subsequent polys should be obstacles within it.
+    //   assuming CCW orientation, DT should be done here so that meta-lines
+    //   are added to (the cell and) the router in their
+    //   proper (memory) locality.
+    // - inner polys (obstacles) shall not intersect with the outer (first)
+    //   poly, and with each other; otherwise triangulators may fail (CGAL, eg.).
+    //   this is not a limitation, only a restriction.
+    // - inner polys shall not contain (completing) metalines.
+    for (auto xPolygons { xCell.child(polygonS) };
+         xPolygons;
+         xPolygons = xPolygons.next_sibling(polygonS))
+    {
+        std::vector<smr::Point> poly;
+        std::vector<smr::Line>  walls;
+        std::vector<smr::Line>  susos;
+        std::vector<TriType>    susoExts;
+        std::vector<BlobType>   blobs;
 
-            bool inBlob { false };
+        bool inBlob { false };
+        
+        auto const xPoint0 { xPolygons.child(pointS) };
+        
+        for (auto xPoint { xPolygons.child(pointS) };
+             xPoint;
+             xPoint = xPoint.next_sibling(pointS)   )
+        {
+            smr::Point u { xAsDouble (xPoint.attribute(xCordS).value()), 
+                           xAsDouble (xPoint.attribute(yCordS).value()) };
             
-            auto const xPoint0 { xPolygons.child(pointS) };
+            /* for subsolid lines, 'cIdx == cellIdx' signals an EXIT line */
+            LCType  const cTyp { xAsLCType (xPoint.attribute(lineCTS).value()) };  // color   type
+            IdxType const sIdx { xAsIdxType(xPoint.attribute(sIdxS  ).value()) };  // (s)elf  idx
+            IdxType       cIdx { xAsIdxType(xPoint.attribute(cIdxS  ).value()) };  // o.cell  idx
+            IdxType const oIdx { xAsIdxType(xPoint.attribute(oIdxS  ).value()) };  // (o)ther idx
+            bool    const pFlg { xPoint.attribute(parityS).as_bool(false)      };  // parity  flag
+
+            if (cTyp == exitColor)
+                cIdx = cellIdx;
             
-            for (auto xPoint { xPolygons.child(pointS) };
-                 xPoint;
-                 xPoint = xPoint.next_sibling(pointS)   )
-            {
-                smr::Point u { xAsDouble (xPoint.attribute(xCordS).value()), 
-                               xAsDouble (xPoint.attribute(yCordS).value()) };
-                
-                /* for subsolid lines, 'cIdx == cellIdx' signals an EXIT line */
-                LCType  const cTyp { xAsLCType (xPoint.attribute(lineCTS).value()) };  // color   type
-                IdxType const sIdx { xAsIdxType(xPoint.attribute(sIdxS  ).value()) };  // (s)elf  idx
-                IdxType       cIdx { xAsIdxType(xPoint.attribute(cIdxS  ).value()) };  // o.cell  idx
-                IdxType const oIdx { xAsIdxType(xPoint.attribute(oIdxS  ).value()) };  // (o)ther idx
-                bool    const pFlg { xPoint.attribute(parityS).as_bool(false)      };  // parity  flag
-
-                if (cTyp == exitColor)
-                    cIdx = cellIdx;
-                
-                if ( cTyp >= invdColor)
-                    return fmt::format("invalid line color ({}) encountered", cTyp);
+            if ( cTyp >= invdColor)
+                return fmt::format("invalid line color ({}) encountered", cTyp);
 
-                if ((cTyp == infcColor) and not (sIdx and cIdx and oIdx))
-                    return fmt::format("invalid interface index combination ({}, {}, {})"
-                                       " encountered in cell {}; expected only positive values",
-                                       sIdx, cIdx, oIdx, cellIdx);
-                
-                auto xNextPoint { xPoint.next_sibling(pointS) };
-                if (not xNextPoint)
-                    xNextPoint = xPoint0;
+            if ((cTyp == infcColor) and not (sIdx and cIdx and oIdx))
+                return fmt::format("invalid interface index combination ({}, {}, {})"
+                                   " encountered in cell {}; expected only positive values",
+                                   sIdx, cIdx, oIdx, cellIdx);
+            
+            auto xNextPoint { xPoint.next_sibling(pointS) };
+            if (not xNextPoint)
+                xNextPoint = xPoint0;
 
-                if (pFlg)
-                    geometry.addParityFlag(cellIdx, cIdx);
-                
-                smr::Point v { xAsDouble(xNextPoint.attribute(xCordS).value()),
-                               xAsDouble(xNextPoint.attribute(yCordS).value()) };
+            if (pFlg)
+                geometry.addParityFlag(cellIdx, cIdx);
+            
+            smr::Point v { xAsDouble(xNextPoint.attribute(xCordS).value()),
+                           xAsDouble(xNextPoint.attribute(yCordS).value()) };
 
-                poly.push_back(u);
-                
-                smr::Line line { u, v };
-                orderPoints(line);
+            poly.push_back(u);
+            
+            smr::Line line { u, v };
+            orderPoints(line);
 
-                switch (cTyp)
-                {
-                case soldColor:
-                    
-                    walls.push_back(std::move(line));
+            switch (cTyp)
+            {
+            case soldColor:
+                
+                walls.push_back(std::move(line));
 
-                    inBlob = false;
+                inBlob = false;
 
-                    break;
+                break;
 
-                case infcColor:
+            case infcColor:
 
-                    if (inBlob)
-                        blobs.back().push_back(sIdx);
-                    else
-                    {
-                        blobs.emplace_back(BlobType { sIdx });
-                        inBlob = true;
-                    }
-                    [[ fallthrough ]];
-                case exitColor:
+                if (inBlob)
+                    blobs.back().push_back(sIdx);
+                else
+                {
+                    blobs.emplace_back(BlobType { sIdx });
+                    inBlob = true;
+                }
+                [[ fallthrough ]];
+            case exitColor:
 
-                    susos   .push_back(std::move(line));
+                susos   .push_back(std::move(line));
 					susoExts.push_back(TriType { sIdx, cIdx, oIdx });
 
-                    break;
-                }
+                break;
             }
-
-            cell.addPoly(std::move(poly),
-                         std::move(walls),
-                         std::move(susos),
-                         std::move(susoExts),
-                         std::move(blobs)   );
         }
-        
-        if (auto const err { parseCellExt(xCell, partition) })
-            return err.value();
 
-        if (auto const err { ftr.get() })
-            return err.value();
-        
-        ftr = std::async(
-            [this] (Cell && cell)
-            {
-                return geometry.processCell(std::move(cell));
-            },
-            std::move(cell));
+        cell.addPoly(std::move(poly),
+                     std::move(walls),
+                     std::move(susos),
+                     std::move(susoExts),
+                     std::move(blobs)   );
     }
-    if (auto const err { ftr.get() })
-        return err.value();
 
     return {};
 }
-
-
@@ -31,7 +31,10 @@
 
 #include "pugixml.hpp"
 
+#include "spawner.hpp"
 
+
+class Cell;
 class Geometry;
 class Partition;
 
@@ -42,9 +45,10 @@ public:
              Parser() = delete;
     virtual ~Parser() = default;
 
-    Parser(std::filesystem::path const & geomPath ,
-           Geometry                    & geometry ,
-           Partition             const & partition) noexcept;
+    Parser(std::filesystem::path const & geomPath       ,
+           Geometry                    & geometry       ,
+           Partition             const & partition      ,
+           ThreadCntType                 ntd       = NTD) noexcept;
     
     virtual std::optional<std::string>
     parse();
@@ -56,14 +60,27 @@ protected:
     Geometry        & geometry ;
     Partition const & partition;
 
+    /* number of 'Geometry::prepareCell' workers */
+    ThreadCntType const ntd;
+
     virtual std::optional<std::string>
     parsePartition(pugi::xml_node const & xPartition) const;
 
+    std::optional<std::string>
+    parseCell(pugi::xml_node const & xCell, Cell & cell) const;
+
     virtual std::optional<std::string>
     parseCellExt([[ maybe_unused ]] pugi::xml_node const & xCell    ,
                  [[ maybe_unused ]] Partition      const & partition) const
     {
             return {};
     }
+
+public:
+
+    static ThreadCntType constexpr NTD { 4 };
+
+    /* maximum number of in-flight cells per worker */
+    static IdxType constexpr BND { 4 };
 };
 
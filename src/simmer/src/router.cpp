@@ -29,10 +29,220 @@
 #include "finder.hpp"
 
 
-Router::Router(Geometry const & geometry, Finder const & finder)
+/* heap bytes of a table (approximate for hash maps) */
+template <typename T>
+inline std::size_t
+bytes(std::vector<T> const & v) noexcept
+{
+    return v.capacity() * sizeof(T);
+}
+
+
+template <typename K, typename V>
+inline std::size_t
+bytes(std::unordered_map<K, V> const & m) noexcept
+{
+    /* a node holds the value and a link (and maybe the hash) */
+    return m.size() * (sizeof(std::pair<K const, V>) + 2 * sizeof(void *))
+         + m.bucket_count() * sizeof(void *);
+}
+
+
+template <typename T>
+inline std::size_t
+bytes(std::vector<std::vector<T>> const & v) noexcept
+{
+    return std::accumulate(v.cbegin(), v.cend(), v.capacity() * sizeof(std::vector<T>),
+                           [] (std::size_t n, auto const & w) { return n + bytes(w); });
+}
+
+
+template <typename K, typename V>
+inline std::size_t
+bytes(std::vector<std::unordered_map<K, V>> const & v) noexcept
+{
+    return std::accumulate(v.cbegin(), v.cend(), v.capacity() * sizeof(std::unordered_map<K, V>),
+                           [] (std::size_t n, auto const & m) { return n + bytes(m); });
+}
+
+
+/* releases the memory of tables */
+template <typename ... T>
+inline void
+release(T & ... t)
+{
+    (T {}.swap(t), ...);
+}
+
+
+/**
+ * Directions out of 'apex' through the portals (interface blobs) passed
+ * so far, as an angle interval about 'ref'; a segment clear of walls and
+ * pseudo-walls leaves every traversed cell through its exit portal, so a
+ * head outside the funnel is hidden, as is everything past a closed one.
+ *
+ * A head inside it is still tested against the walls of each cell
+ * traversed, bar those it has narrowed into the gap left by them since
+ * (see 'cut'): it only narrows, and the walls of a cell only go, so the
+ * gap of a cell, taken as it is left, holds for the heads to come.
+ */
+struct FunnelType
+{
+    using GapType = std::pair<CrdType, CrdType>;
+
+    static GapType constexpr NOGAP { std::numbers::pi_v<CrdType>, -std::numbers::pi_v<CrdType> };
+
+    smr::Point apex {};
+    smr::Point ref  {};
+
+    /* clearance of the sight lines */
+    CrdType cpa { smr::Param::CPA };
+
+    CrdType lo { -std::numbers::pi_v<CrdType> };
+    CrdType hi {  std::numbers::pi_v<CrdType> };
+
+    /* frame of the current cell to that of 'apex' */
+    CrdType    a {};
+    smr::Point b {};
+
+    smr::Point toApex(smr::Point const & p) const noexcept { return rotate(p, a) + b; }
+
+    CrdType angle(smr::Point const & p) const noexcept
+    {
+        auto const v { toApex(p) - apex };
+
+        return std::atan2(vctrCross(ref, v), vctrDot(ref, v));
+    }
+
+    /* the angle 'c' subtends at 'd' from the apex */
+    static CrdType span(CrdType c, CrdType d) noexcept { return std::asin(std::min(c / d, CrdType { 1 })); }
+
+    bool closed  ()                     const noexcept { return lo > hi; }
+    bool contains(smr::Point const & p) const noexcept
+    {
+        auto const t { angle(p) };
+
+        return (lo <= t) and (t <= hi);
+    }
+
+    /* 'ends' in the frame of the current cell */
+    void narrow(std::vector<smr::Point> const & ends) noexcept
+    {
+        [[ unlikely ]]
+        if (ref == smr::Point {})
+        {
+            for (auto const & p : ends)
+                ref = ref + (toApex(p) - apex);
+
+            [[ unlikely ]]
+            if (ref == smr::Point {})
+                return;
+        }
+
+        CrdType loP { std::numbers::pi_v<CrdType> };
+        CrdType hiP { -loP };
+
+        for (auto const & p : ends)
+        {
+            auto const d { lineNorm({ toApex(p), apex }) };
+
+            /* the apex on the portal sees all around */
+            [[ unlikely ]]
+            if (fELess(d, cpa))
+                return;
+
+            // a sight line may graze an end by up to the clearance, the
+            // rounding of the frames being well within it
+            auto const t { angle(p) };
+            auto const g { span(cpa, d) };
+
+            loP = std::min(loP, t - g);
+            hiP = std::max(hiP, t + g);
+        }
+
+        /* wraps around behind the apex */
+        if ((hiP - loP) >= std::numbers::pi_v<CrdType>)
+            return;
+
+        lo = std::max(lo, loP);
+        hi = std::min(hi, hiP);
+    }
+
+    // narrows 'gap' by 'w', in the frame of the current cell: the gap is
+    // the part of the funnel whose sight lines all keep twice the
+    // clearance off the walls cut by so far; the angles of a wall, grown
+    // by those the clearance subtends at its nearest point, are taken off
+    // either end of it, or leave none should they fall inside
+    void cut(smr::Line const & w, GapType & gap) const noexcept
+    {
+        auto const pi { std::numbers::pi_v<CrdType> };
+
+        auto const d { pointLineDistance(apex, { toApex(w.u), toApex(w.v) }) };
+
+        if (not (d > 2 * cpa))
+        {
+            gap = NOGAP;
+
+            return;
+        }
+
+        auto tu { angle(w.u) };
+        auto tv { angle(w.v) };
+
+        if (tu > tv)
+            std::swap(tu, tv);
+
+        /* a wall spans less than half a turn: past that, it wraps around behind the apex */
+        auto const wrap { (tv - tu) > pi };
+
+        auto const c { (tu + tv) / 2 + (wrap ? pi : 0) };
+        auto const h { (wrap ? 2 * pi - (tv - tu) : (tv - tu)) / 2 + span(2 * cpa, d) };
+
+        /* about the middle of the funnel */
+        auto const fc { (lo + hi) / 2                  };
+        auto const fh { (hi - lo) / 2                  };
+        auto const x  { std::remainder(c - fc, 2 * pi) };
+
+        if (std::fabs(x) > h + fh)
+            return;
+
+        /* it could meet either end round the back */
+        if (h + fh >= pi)
+        {
+            gap = NOGAP;
+
+            return;
+        }
+
+        auto const cutLo { (x - h <= -fh) };
+        auto const cutHi { (x + h >=  fh) };
+
+        if (cutLo)
+            gap.first  = std::max(gap.first , fc + x + h);
+        if (cutHi)
+            gap.second = std::min(gap.second, fc + x - h);
+
+        if (not (cutLo or cutHi))
+            gap = NOGAP;
+    }
+
+    bool within(GapType const & gap) const noexcept { return (gap.first <= lo) and (hi <= gap.second); }
+
+    /* moves on with 'd', the dictionary of the next cell to the current one */
+    void advance(DctType const & d) noexcept
+    {
+        b = rotate(d.tS - rotate(d.tP, d.a), a) + b;
+        a = a + d.a;
+    }
+};
+
+
+Router::Router(Geometry const & geometry, Finder const & finder, bool lFlg, bool hFlg)
 
 : geometry { geometry },
-  finder   { finder   }
+  finder   { finder   },
+  lFlg     { lFlg     },
+  hFlg     { hFlg     }
 {
     auto const xSize { geometry.getNosoz().size() };
 
@@ -40,8 +250,30 @@ Router::Router(Geometry const & geometry, Finder const & finder)
     distMCSs.resize(xSize);
     dcts    .resize(xSize);
 
-    /* dispatch finder.findLocal .. */
-    auto ftr { std::async([this, & finder] { finder.findLocal(pathMCSs, distMCSs); }) };
+    if (lFlg)
+    {
+        pathIMs.resize(xSize);
+        distIMs.resize(xSize);
+
+        mcsOnce = std::make_unique<std::once_flag[]>(xSize);
+        nxtOnce = std::make_unique<std::once_flag[]>(xSize);
+
+        nextz .resize(xSize);
+        lShrtz.resize(xSize);
+    }
+
+    /* dispatch finder.findLocal (or findInterface) .. */
+    auto ftr
+    {
+        std::async(
+            [this, & finder, lFlg]
+            {
+                if (lFlg)
+                    finder.findInterface(pathIMs, distIMs);
+                else
+                    finder.findLocal(pathMCSs, distMCSs);
+            })
+    };
 
     /* .. and overlap independent work */
     consolidate();
@@ -49,46 +281,97 @@ Router::Router(Geometry const & geometry, Finder const & finder)
     
     ftr.get      ();
 	patchUp      ();
+
+    if (not lFlg)
+        populateNexts();
+}
+
+
+Router::Router(Geometry const & geometry, Finder const & finder, MCSsType && mcss, bool hFlg)
+
+: geometry { geometry                     },
+  finder   { finder                       },
+  lFlg     { false                        },
+  hFlg     { hFlg                         },
+  pathMCSs { std::move(mcss.pathMCSs)     },
+  distMCSs { std::move(mcss.distMCSs)     }
+{
+    dcts.resize(geometry.getNosoz().size());
+
+    consolidate  ();
+    formDicts    ();
+	patchUp      ();
 	populateNexts();
 }
 
 
 IdxType
-Router::findLine(IdxType cIdx, smr::Point const & pt) const noexcept
+Router::findLine(IdxType cIdx, smr::Point const & pt) const
+{
+    ScratchType scr;
+
+    return findLine(scr, cIdx, pt);
+}
+
+
+IdxType
+Router::findLine(ScratchType & scr, IdxType cIdx, smr::Point const & pt) const
 {
     auto const & nosos { geometry.getNosoz()[cIdx] };
 
-    auto const cnt { std::min(static_cast<std::size_t>(DICHI), nosos.size()) };
+    auto & vec { scr.vec };
+    vec.resize(nosos.size());
+
+    std::iota(vec.begin(), vec.end(), IdxType {});
 
-    auto const vec
+    auto const cmp
     {
-        [& nosos, & pt, cnt]
+        [& nosos, & pt] (auto const & a, auto const & b)
         {
-            std::vector<IdxType> vec;
-            vec.reserve(nosos.size());
+            return euclideanPLDistance(pt, nosos[a]) < euclideanPLDistance(pt, nosos[b]);
+        }
+    };
 
-            for (IdxType i {}; i < nosos.size(); i++)
-                vec.push_back(i);
+    auto & dst { scr.dst };
 
-            std::partial_sort(vec.begin(), vec.begin() + cnt, vec.end(), [& nosos, & pt] (auto const & a, auto const & b)
-                {
-                    return euclideanPLDistance(pt, nosos[a]) < euclideanPLDistance(pt, nosos[b]);
-                });
+    // the closest 'DICHI' lines, and the next 'DICHI' ones should
+    // they all be hidden; fine meshes may pack more than 'DICHI'
+    // lines around an obstacle corner
+    for (IdxType bgn {}; bgn < nosos.size(); bgn += DICHI)
+    {
+        auto const end { std::min(bgn + DICHI, static_cast<IdxType>(nosos.size())) };
 
-            return vec;
-        }()
-    };
+        std::partial_sort(vec.begin() + bgn, vec.begin() + end, vec.end(), cmp);
 
-    std::vector<CrdType> dst;
-    dst.reserve(cnt);
+        dst.clear();
 
-    for (IdxType i {}; i < cnt; i++)
-        if (not geometry.intersectsWalls({ pt, linePoint(nosos[vec[i]]) }, cIdx))
-            dst.push_back(euclideanPLDistance(pt, nosos[vec[i]]) + lShrtz[cIdx][vec[i]]);
-        else
-            dst.push_back(std::numeric_limits<CrdType>::infinity());
+        /* the closest visible line */
+        IdxType vIdx { IdxTypeMax };
+        
+        for (IdxType i { bgn }; i < end; i++)
+            if (not geometry.intersectsWallsTo({ pt, linePoint(nosos[vec[i]]) }, cIdx, vec[i]))
+            {
+                dst.push_back(euclideanPLDistance(pt, nosos[vec[i]]) + lShrt(cIdx, vec[i]));
+
+                if (vIdx == IdxTypeMax)
+                    vIdx = vec[i];
+            }
+            else
+                dst.push_back(std::numeric_limits<CrdType>::infinity());
+
+        auto const itr { std::min_element(dst.cbegin(), dst.cend()) };
+
+        if (*itr != std::numeric_limits<CrdType>::infinity())
+            return vec[bgn + std::distance(dst.cbegin(), itr)];
 
-    return vec[std::distance(dst.cbegin(), std::min_element(dst.cbegin(), dst.cend()))];
+        // the lines of a cell are all cut off from the exits, or none
+        // (see 'block'); no further line would do better then
+        [[ unlikely ]]
+        if (vIdx != IdxTypeMax)
+            return vIdx;
+    }
+
+    return vec.front();
 }
 
 
@@ -98,9 +381,9 @@ Router::findLine(IdxType cIdx, smr::Point const & pt) const noexcept
  * | smr::Line.v : direction (unit-norm velocity)
  */
 std::pair<IdxType, smr::Line>
-Router::findCell(std::vector<smr::Line> const & lines,
-                 std::vector<DuoType>   const & cells,
-                 CrdType                const   s    ) const noexcept
+Router::findCell(std::span<smr::Line const> lines,
+                 std::span<DuoType   const> cells,
+                 CrdType              const s    ) const noexcept
 {
     IdxType idx { IdxTypeMax };
 
@@ -125,59 +408,148 @@ Router::findVisible(IdxType            cIdx,
                     IdxType            hop ,
                     CrdType    const   cpa ) const
 {
-    auto const & nosoz { geometry.getNosoz() };
+    ScratchType scr;
 
-    DuoType duoP { cIdx, findLine(cIdx, pt) };
+    auto const [lines, cells] { * findVisible(scr, cIdx, pt, std::nullopt, hop, CrdTypeMax, cpa) };
 
-    [[ maybe_unused ]]
-    auto const sIdx { duoP.sIdx };
+    return { { lines.begin(), lines.end() }, { cells.begin(), cells.end() } };
+}
 
-    /* the two vectors maintain an identical size */
-    std::vector<DuoType>    cells { duoP };
-    std::vector<smr::Point> tails { pt   };
+
+/**
+ * As above, into the buffers of 'scr', which the views returned refer to,
+ * and stopping at the first visible target further than 'rch' from 'pt';
+ * with 'trgt' known to be visible from 'pt' (a target found from a point
+ * behind it, on the way), hops short of it are not tested, as it
+ * supersedes them, bar those that could be past the reach; empty if
+ * 'trgt' is not met, or hidden
+ */
+std::optional<NaviView>
+Router::findVisible(ScratchType                  & scr ,
+                    IdxType                        cIdx,
+                    smr::Point             const & pt  ,
+                    std::optional<DuoType> const & trgt,
+                    IdxType                        hop ,
+                    CrdType                const   rch ,
+                    CrdType                const   cpa ) const
+{
+    auto const & nosoz { geometry.getNosoz() };
+    auto const & wallz { geometry.getWallz() };
+
+    DuoType duoP { cIdx, findLine(scr, cIdx, pt) };
+
+    /* the four vectors maintain an identical size */
+    auto & cells { scr.cells };
+    auto & tails { scr.tails };
+    auto & setz  { scr.setz  };
+    auto & gaps  { scr.gaps  };
     /* tails is the translation of pt in all viable cells */
 
-    std::vector<smr::Line> lines { { pt, linePoint(nosoz[duoP.cIdx][duoP.sIdx]) } };
+    cells.assign(1, duoP);
+    tails.assign(1, pt  );
+    setz .assign(1, PseudoType::NONE);
+    gaps .assign(1, FunnelType::NOGAP);
 
-    std::unordered_map<IdxType, std::unordered_set<IdxType>> pseudoz;
+    auto & lines  { scr.lines  };
+    auto & linesT { scr.linesT };
+
+    lines.assign(1, { pt, linePoint(nosoz[duoP.cIdx][duoP.sIdx]) });
+
+    auto & pseudoz { scr.pseudoz };
+    pseudoz.clear();
+
+    // the start cell is walled off by its other interfaces only when the
+    // route leaves it at the first hop; else it keeps none, as it always has
+    if (hop and (next(duoP.cIdx, duoP.sIdx).cIdx == duoP.cIdx))
+        setz.back() = pseudoz.add(duoP.cIdx);
 
     IdxType dmp {};
 
+    FunnelType fnl { .apex = pt, .cpa = cpa };
+
+    auto & ends { scr.ends };
+
+    bool ahead { trgt.has_value() };  /* short of 'trgt' */
+
     while (hop--)
     {
         bool visible { true  };
         bool cTrnsn  { false };  /* cell transition flag */
         bool hitExit { false };
         
-        auto const & duoS = nextz[duoP.cIdx][duoP.sIdx];
+        auto const duoS { next(duoP.cIdx, duoP.sIdx) };
+
+        /* a route cut off from every exit ends where it is (see 'block') */
+        [[ unlikely ]]
+        if ((duoS.cIdx == duoP.cIdx) and (duoS.sIdx == duoP.sIdx) and (not isExit(duoS.cIdx, duoS.sIdx)))
+            break;
+
+        bool const isTrgt { ahead and (duoS.cIdx == trgt->cIdx) and (duoS.sIdx == trgt->sIdx) };
         
         [[ unlikely ]]
         if (duoS.cIdx != duoP.cIdx)
         {
+            auto const [setP, setS] { subtractInfc(pseudoz, duoP.cIdx, duoP.sIdx, setz.back()) };
+
+            setz.back() = setP;
+
             cells.push_back(duoS);
             tails.emplace_back(translate(duoP.cIdx, duoS.cIdx, tails.back()));
+            setz .push_back(setS);
+            gaps .push_back(FunnelType::NOGAP);
+
+            ends.clear();
+
+            for (auto const i : geometry.getBlob(duoP.cIdx, duoP.sIdx))
+            {
+                ends.push_back(nosoz[duoP.cIdx][i].u);
+                ends.push_back(nosoz[duoP.cIdx][i].v);
+            }
+
+            fnl.narrow (ends);
+            fnl.advance(dct(duoS.cIdx, duoP.cIdx));
+
+            /* nothing past here is visible; what is left would only be dumped */
+            if (fnl.closed())
+            {
+                dmp++;
+
+                break;
+            }
+
+            /* the gap of the cell left, in which it is tested no more */
+            gaps.back() = { fnl.lo, fnl.hi };
 
-            subtractInfc(pseudoz, duoP.cIdx, duoP.sIdx);
+            for (auto const & w : wallz[duoP.cIdx])
+                fnl.cut(w, gaps.back());
+            for (auto const sIdx : pseudoz[setP])
+                fnl.cut(nosoz[duoP.cIdx][sIdx], gaps.back());
 
             cTrnsn = true;
         }
-        else if (geometry.isExit(duoS.cIdx, duoS.sIdx))
+        else if (isExit(duoS.cIdx, duoS.sIdx))
         {
-            if (pseudoz.contains(duoS.cIdx))
-                pseudoz[duoS.cIdx].erase(duoS.sIdx);
+            if (setz.back() != PseudoType::NONE)
+                std::erase(pseudoz[setz.back()], duoS.sIdx);
 
             hitExit = true;
         }
         
-        std::vector<smr::Line> linesT;
         linesT.resize(cells.size());
         
         auto head { linePoint(nosoz[duoS.cIdx][duoS.sIdx]) };
         linesT.back() = { tails.back(), head };
 
-        if (geometry.intersectsWalls(linesT.back(), duoS.cIdx, pseudoz[duoS.cIdx], cpa))
+        // hops short of 'trgt' are skipped, but for those that could be
+        // past the reach, which a search from scratch would stop at
+        if (ahead and (not isTrgt) and (lineNorm({ fnl.toApex(head), pt }) + smr::Param::CPA <= rch))
+            visible = false;
+        else if (not fnl.contains(head))
+            visible = false;
+        else if (geometry.intersectsWallsTo(linesT.back(), duoS.cIdx, duoS.sIdx, pseudoz.view(setz.back()), cpa))
             visible = false;
 
+        /* past the funnel, each traversed cell is still tested, bar those it has narrowed clear of (see 'FunnelType') */
         if (visible)
         {
             for (auto i { cells.size() - 1 }; i > 0; i--)
@@ -188,7 +560,10 @@ Router::findVisible(IdxType            cIdx,
 
                 linesT[i-1] = { tails[i-1], head };
 
-                if (geometry.intersectsWalls(linesT[i-1], ccIdx, pseudoz[ccIdx], cpa))
+                if (fnl.within(gaps[i-1]))
+                    continue;
+
+                if (geometry.intersectsWalls(linesT[i-1], ccIdx, pseudoz.view(setz[i-1]), cpa))
                 {
                     visible = false;
 
@@ -197,6 +572,12 @@ Router::findVisible(IdxType            cIdx,
             }
         }
 
+        [[ unlikely ]]
+        if (isTrgt and (not visible))
+            return {};
+
+        ahead = ahead and (not isTrgt);
+
         if (not visible)
         {
             if (cTrnsn)
@@ -212,7 +593,7 @@ Router::findVisible(IdxType            cIdx,
         }
         dmp = 0;
         
-        lines = std::move(linesT);
+        lines.swap(linesT);
 
         [[ likely ]]
         if (not cTrnsn)                     /* update the 'sIdx' field */
@@ -223,10 +604,52 @@ Router::findVisible(IdxType            cIdx,
         [[ unlikely ]]
         if (hitExit)
             break;
+
+        /* far enough ('head' is in the frame of 'pt' now); supersedes the hops skipped */
+        if (rch < lineNorm(lines.front()))
+        {
+            ahead = false;
+
+            break;
+        }
     }
 
+    if (ahead)
+        return {};
+
     cells.resize(cells.size() - dmp);
+    setz .resize(cells.size());
+    gaps .resize(cells.size());
     
+    return NaviView { lines, cells };
+}
+
+
+NaviView
+Router::retrace(ScratchType & scr, smr::Point const & pt, std::span<DuoType const> cells) const
+{
+    auto const & nosoz { geometry.getNosoz() };
+
+    auto & tails { scr.tails };
+    auto & lines { scr.lines };
+
+    tails.assign(1, pt);
+
+    for (IdxType i { 1 }; i < cells.size(); i++)
+        tails.emplace_back(translate(cells[i-1].cIdx, cells[i].cIdx, tails.back()));
+
+    lines.resize(cells.size());
+
+    auto head { linePoint(nosoz[cells.back().cIdx][cells.back().sIdx]) };
+    lines.back() = { tails.back(), head };
+
+    for (auto i { cells.size() - 1 }; i > 0; i--)
+    {
+        head = translate(cells[i].cIdx, cells[i-1].cIdx, head);
+
+        lines[i-1] = { tails[i-1], head };
+    }
+
     return { lines, cells };
 }
 
@@ -251,7 +674,11 @@ Router::findVisibleG(IdxType            cIdx,
     
     while (hop--)
     {
-        auto const & duoS = nextz[duoP.cIdx][duoP.sIdx];
+        auto const duoS { next(duoP.cIdx, duoP.sIdx) };
+
+        [[ unlikely ]]
+        if ((duoS.cIdx == duoP.cIdx) and (duoS.sIdx == duoP.sIdx) and (not isExit(duoS.cIdx, duoS.sIdx)))
+            break;
         
         bool cTrnsn { false };
 
@@ -269,7 +696,7 @@ Router::findVisibleG(IdxType            cIdx,
         auto head { linePoint(nosoz[duoS.cIdx][duoS.sIdx]) };
         linesT.back() = { tails.back(), head };
 
-        if (geometry.intersectsWalls(linesT.back(), duoS.cIdx, cpa))
+        if (geometry.intersectsWallsTo(linesT.back(), duoS.cIdx, duoS.sIdx, cpa))
             visible = false;
 
         if (visible)
@@ -302,7 +729,7 @@ Router::findVisibleG(IdxType            cIdx,
         duoP = duoS;
         
         [[ unlikely ]]
-        if (geometry.isExit(duoS.cIdx, duoS.sIdx))
+        if (isExit(duoS.cIdx, duoS.sIdx))
             break;
     }
 
@@ -315,7 +742,7 @@ Router::findVisibleG(IdxType            cIdx,
 smr::Line
 Router::translate(IdxType cIdxP, IdxType cIdxS, smr::Line const & l) const noexcept
 {
-    auto const & d { dcts[cIdxP].at(cIdxS) };
+    auto const & d { dct(cIdxP, cIdxS) };
 
     auto const u { rotate(l.u - d.tP, d.a) + d.tS };
     auto const v { rotate(l.v - d.tP, d.a) + d.tS };
@@ -327,197 +754,373 @@ Router::translate(IdxType cIdxP, IdxType cIdxS, smr::Line const & l) const noexc
 smr::Point
 Router::translate(IdxType cIdxP, IdxType cIdxS, smr::Point const & p) const noexcept
 {
-    auto const & d { dcts[cIdxP].at(cIdxS) };
+    auto const & d { dct(cIdxP, cIdxS) };
 
     return rotate(p - d.tP, d.a) + d.tS;
 }
 
 
-void
-Router::consolidate()
+std::optional<std::string>
+Router::compact()
 {
-    auto const & susoExtz { geometry.getSusoExtz() };
-    
-    /* temporary bookkeeping containers */
-	std::vector<std::unordered_map<IdxType, IdxType>> clonz;
-	decltype(clonz)::value_type                       clons;
+    if (kFlg)
+        return {};
 
-    for (IdxType i {}; i < susoExtz.size(); i++)
+    /* the blocked lines are told by their global indices, which go */
+    if (std::find(gBlks.cbegin(), gBlks.cend(), true) != gBlks.cend())
+        return "a router with blocked lines cannot be compacted";
+
+    auto const & nosoz { geometry.getNosoz() };
+    auto const   xSize { nosoz.size()        };
+
+    auto const lines
     {
-        auto       & susoExts     { susoExtz[i]     };
-        auto const   susoExtsSize { susoExts.size() };
+        std::accumulate(nosoz.cbegin(), nosoz.cend(), std::size_t {},
+                        [] (std::size_t n, auto const & nosos) { return n + nosos.size(); })
+    };
 
-        decltype(gIdz)::value_type gIds;
-		gIds.reserve(susoExtsSize);
-        
+    if (lines >= std::numeric_limits<std::uint32_t>::max())
+        return fmt::format("too many lines ({}) for a compact router", lines);
 
-        for (IdxType j {}; j < susoExtsSize; j++)
-        {
-			auto const & [sIdx, cIdx, oIdx] { susoExts[j] };
+    /* a lazy router forms the remaining cells first */
+    for (IdxType i {}; i < xSize; i++)
+        ensure(i);
 
-            if (cIdx >= i)
-            {
-				gIds.push_back(gIdx);
+    gOffs .reserve(xSize + 1);
+    gNexts.reserve(lines    );
+    gShrtz.reserve(lines    );
 
-				quads.push_back({ i, sIdx, IdxTypeMax, IdxTypeMax });
+    for (IdxType i {}; i < xSize; i++)
+    {
+        gOffs.push_back(static_cast<std::uint32_t>(gNexts.size()));
 
-                if (cIdx == i)
-                    gEIds.push_back(gIdx);
+        for (IdxType j {}; j < nosoz[i].size(); j++)
+        {
+            auto const & duo { nextz[i][j] };
 
-				clons.insert({ sIdx, gIdx });
+            gNexts.push_back({ static_cast<std::uint32_t>(duo.cIdx), static_cast<std::uint32_t>(duo.sIdx) });
+            gShrtz.push_back(static_cast<float>(lShrtz[i][j]));
+        }
+    }
+    gOffs.push_back(static_cast<std::uint32_t>(gNexts.size()));
 
-                gIdx++;
-            }
-            else
-            {
-				auto const gIdxO { clonz[cIdx].at(oIdx) };
+    dOffs.reserve(xSize + 1);
 
-				gIds.push_back(gIdxO);
+    for (IdxType i {}; i < xSize; i++)
+    {
+        dOffs.push_back(static_cast<std::uint32_t>(gDcts.size()));
 
-				auto & quad { quads[gIdxO] };
-				quad = { quad.cIdxP, quad.sIdxP, i, sIdx };
-			}
-        }
+        for (auto const & [cIdx, d] : dcts[i])
+            gDcts.emplace_back(static_cast<std::uint32_t>(cIdx), d);
 
-		clonz.emplace_back(std::move(clons ));
-		gIdz .emplace_back(std::move(gIds));
+        std::sort(gDcts.begin() + dOffs.back(), gDcts.end(),
+                  [] (auto const & a, auto const & b) { return a.first < b.first; });
     }
-}
+    dOffs.push_back(static_cast<std::uint32_t>(gDcts.size()));
 
+    gDcts.shrink_to_fit();
 
-void
-Router::formDicts()
-{
-    auto const & susoExtz { geometry.getSusoExtz() };
-    auto const & nosoz    { geometry.getNosoz()    };
-    
-    for (IdxType i {}; i < susoExtz.size(); i++)
-    {
-        auto const & susoExts { susoExtz[i] };
+    release(pathMCSs, distMCSs, pathIMs, distIMs,
+            pathM, distM, distMCS, quads, gEIds, gIdz, gShrts,
+            lShrtz, nextz, dcts, gGrph, gNxts, gBlks);
 
-        auto const pMap { geometry.getPMaps(i) };
-        
-        for (IdxType j {}; j < susoExts.size(); j++)
-        {
-            auto const & tri { susoExts[j] };
+    hier = {};
 
-            /* equality excludes EXIT lines */
-            if ((i == tri.cIdx) or dcts[i].contains(tri.cIdx))
-                continue;
-            
-            auto const & lineP { nosoz[i       ][tri.sIdx] };
-            auto const & lineS { nosoz[tri.cIdx][tri.oIdx] };
+    publish({});
+    reclaim();
 
-            smr::Point const ptP { lineP.v - lineP.u };
-            smr::Point const ptS { lineS.v - lineS.u };
+    mcsOnce.reset();
+    nxtOnce.reset();
 
-            /* construct the dictionary */
-            DctType dctPS;
+    kFlg = true;
 
-            /* sign */
-            dctPS.s = fELess(0., vctrDot(ptP, ptS)) ? true : false;
+    return {};
+}
 
-            /* translation */
-            dctPS.tP = linePoint(lineP);
-            dctPS.tS = linePoint(lineS);
 
-            auto const pty { pMap.contains(tri.cIdx) };
+std::size_t
+Router::footprint() const noexcept
+{
+    auto const xSize { geometry.getNosoz().size() };
 
-            /* rotation */
-            /* order of arguments matters */
-            dctPS.a = vctrAngle(lineP.v - dctPS.tP, ((pty xor dctPS.s) ? lineS.v : lineS.u) - dctPS.tS);
-            
-            /* xS = R(a) * (xP - tP) + tS */
+    std::size_t const once { (mcsOnce ? xSize : 0) + (nxtOnce ? xSize : 0) };
 
-            /* dispatch */
-            dcts[i].insert({ tri.cIdx, std::move(dctPS) });
-        }
-    }
+    std::size_t snaps {};
+
+    for (auto const & snap : { snapC, snapR })
+        if (snap)
+            snaps += bytes(snap->offs) + bytes(snap->nexts) + bytes(snap->shrts);
+
+    return bytes(pathMCSs) + bytes(distMCSs) + bytes(pathIMs) + bytes(distIMs)
+         + bytes(pathM   ) + bytes(distM   ) + bytes(distMCS) + bytes(quads  )
+         + bytes(gEIds   ) + bytes(gIdz    ) + bytes(gShrts ) + bytes(lShrtz )
+         + bytes(nextz   ) + bytes(dcts    ) + bytes(gOffs  ) + bytes(gNexts )
+         + bytes(gShrtz  ) + bytes(dOffs   ) + bytes(gDcts  ) + bytes(gGrph  )
+         + bytes(gNxts   ) + gBlks.capacity() / 8  + hier.footprint()
+         + once * sizeof(std::once_flag) + snaps;
 }
 
 
 void
-Router::patchUp()
+Router::consolidate()
 {
-	/* for rerouting */
-	distM  .clear();
-	pathM  .clear();
-	distMCS.clear();
-	gShrts .clear();
-	
-    distM.resize(gIdx * gIdx);
-    pathM.resize(gIdx * gIdx);
-
-    auto const g
-    {
-        [this]
-        {
-            auto const & susoExtz { geometry.getSusoExtz() };
-            
-            GraphType g;
-            g.resize(gIdx);
+    auto const & susoExtz { geometry.getSusoExtz() };
+    auto const & susoMaps { geometry.getSusoMaps() };
 
-            for (IdxType i {}; i < susoExtz.size(); i++)
-            {
-                auto const & susoExts     { susoExtz[i]     };
-                auto const & susoExtsSize { susoExts.size() };
+    auto const xSize { susoExtz.size() };
 
-                for (IdxType j {}; j < susoExtsSize; j++)
-                {
-                    auto const gIdxJ { gIdz[i][j] };
-                    
-                    auto & gIdxJMap { g[gIdxJ] };
+    // a global line is owned by the lower-indexed of its two cells (an
+    // EXIT line by its only cell); owned lines are counted per cell, and
+    // numbered after the prefix sums of the counts
+    std::vector<IdxType> gBgns;
+    std::vector<IdxType> eBgns;
+    gBgns.resize(xSize + 1);
+    eBgns.resize(xSize + 1);
 
-                    for (IdxType k {}; k < susoExtsSize; k++)
+    spawnBlocks(NTD, xSize, BLK,
+        [& susoExtz, & gBgns, & eBgns] (IdxType bgn, IdxType end)
+        {
+            for (IdxType i { bgn }; i < end; i++)
+                for (auto const & trio : susoExtz[i])
+                    if (trio.cIdx >= i)
                     {
-                        auto const gIdxK { gIdz[i][k] };
-
-                        auto const wgt { distMCSs[i][susoExts[j].sIdx * susoExtsSize + k] };
+                        gBgns[i + 1]++;
 
-                        if (not gIdxJMap.contains(gIdxK))
-                            gIdxJMap.insert({ gIdxK, wgt });
-                        else
-                            gIdxJMap.at(gIdxK) = std::min(gIdxJMap.at(gIdxK), wgt);
+                        if (trio.cIdx == i)
+                            eBgns[i + 1]++;
                     }
+        });
+
+    std::inclusive_scan(gBgns.cbegin(), gBgns.cend(), gBgns.begin());
+    std::inclusive_scan(eBgns.cbegin(), eBgns.cend(), eBgns.begin());
+
+    gIdx = gBgns.back();
+
+    gIdz .resize(xSize        );
+    quads.resize(gIdx         );
+    gEIds.resize(eBgns.back());
+
+    /* owned lines */
+    spawnBlocks(NTD, xSize, BLK,
+        [this, & susoExtz, & gBgns, & eBgns] (IdxType bgn, IdxType end)
+        {
+            for (IdxType i { bgn }; i < end; i++)
+            {
+                auto const & susoExts { susoExtz[i] };
+
+                auto & gIds { gIdz[i] };
+                gIds.resize(susoExts.size());
+
+                auto g { gBgns[i] };
+                auto e { eBgns[i] };
+
+                for (IdxType j {}; j < susoExts.size(); j++)
+                {
+                    auto const & [sIdx, cIdx, oIdx] { susoExts[j] };
+
+                    if (cIdx < i)
+                        continue;
+
+                    gIds [j] = g;
+                    quads[g] = { i, sIdx, IdxTypeMax, IdxTypeMax };
+
+                    if (cIdx == i)
+                        gEIds[e++] = g;
+
+                    g++;
+                }
+            }
+        });
+
+    /* the rest take the index of their dual, owned by the other cell */
+    spawnBlocks(NTD, xSize, BLK,
+        [this, & susoExtz, & susoMaps] (IdxType bgn, IdxType end)
+        {
+            for (IdxType i { bgn }; i < end; i++)
+            {
+                auto const & susoExts { susoExtz[i] };
+
+                for (IdxType j {}; j < susoExts.size(); j++)
+                {
+                    auto const & [sIdx, cIdx, oIdx] { susoExts[j] };
+
+                    if (cIdx >= i)
+                        continue;
+
+                    auto const gIdxO { gIdz[cIdx][susoMaps[cIdx].at(oIdx).sIdx] };
+
+                    gIdz[i][j] = gIdxO;
+
+                    auto & quad { quads[gIdxO] };
+                    quad = { quad.cIdxP, quad.sIdxP, i, sIdx };
+                }
+            }
+        });
+}
+
+
+void
+Router::formDicts()
+{
+    auto const & susoExtz { geometry.getSusoExtz() };
+    auto const & nosoz    { geometry.getNosoz()    };
+
+    /* a cell only writes its own dictionaries */
+    spawnBlocks(NTD, susoExtz.size(), BLK,
+        [this, & susoExtz, & nosoz] (IdxType bgn, IdxType end)
+        {
+            for (IdxType i { bgn }; i < end; i++)
+            {
+                auto const & susoExts { susoExtz[i] };
+
+                auto const pMap { geometry.getPMaps(i) };
+        
+                for (IdxType j {}; j < susoExts.size(); j++)
+                {
+                    auto const & tri { susoExts[j] };
+
+                    /* equality excludes EXIT lines */
+                    if ((i == tri.cIdx) or dcts[i].contains(tri.cIdx))
+                        continue;
+            
+                    auto const & lineP { nosoz[i       ][tri.sIdx] };
+                    auto const & lineS { nosoz[tri.cIdx][tri.oIdx] };
+
+                    smr::Point const ptP { lineP.v - lineP.u };
+                    smr::Point const ptS { lineS.v - lineS.u };
+
+                    /* construct the dictionary */
+                    DctType dctPS;
+
+                    /* sign */
+                    dctPS.s = fELess(0., vctrDot(ptP, ptS)) ? true : false;
+
+                    /* translation */
+                    dctPS.tP = linePoint(lineP);
+                    dctPS.tS = linePoint(lineS);
+
+                    auto const pty { pMap.contains(tri.cIdx) };
+
+                    /* rotation */
+                    /* order of arguments matters */
+                    dctPS.a = vctrAngle(lineP.v - dctPS.tP, ((pty xor dctPS.s) ? lineS.v : lineS.u) - dctPS.tS);
+            
+                    /* xS = R(a) * (xP - tP) + tS */
+
+                    /* dispatch */
+                    dcts[i].insert({ tri.cIdx, std::move(dctPS) });
                 }
             }
+        });
+}
+
+
+void
+Router::patchUp()
+{
+	/* for rerouting */
+	distM  .clear();
+	pathM  .clear();
+	distMCS.clear();
+	gShrts .clear();
+
+    // each global line pulls its edges from its (one or two) cells, the
+    // owning (lower-indexed) one first, as the sequential pass did
+    gGrph =
+        [this]
+        {
+            auto const & susoExtz { geometry.getSusoExtz() };
+            
+            GraphType g;
+            g.resize(gIdx);
+
+            spawnBlocks(NTD, gIdx, BLK,
+                [this, & susoExtz, & g] (IdxType bgn, IdxType end)
+                {
+                    for (IdxType gIdxJ { bgn }; gIdxJ < end; gIdxJ++)
+                    {
+                        auto const & quad { quads[gIdxJ] };
+
+                        auto & gIdxJMap { g[gIdxJ] };
+
+                        for (auto const & [cIdx, sIdx] : { DuoType { quad.cIdxP, quad.sIdxP },
+                                                           DuoType { quad.cIdxS, quad.sIdxS } })
+                        {
+                            if (cIdx == IdxTypeMax)
+                                continue;
+
+                            for (IdxType k {}; k < susoExtz[cIdx].size(); k++)
+                            {
+                                auto const gIdxK { gIdz[cIdx][k] };
+
+                                auto const wgt { distMCSAt(cIdx, sIdx, k) };
+
+                                if (not gIdxJMap.contains(gIdxK))
+                                    gIdxJMap.insert({ gIdxK, wgt });
+                                else
+                                    gIdxJMap.at(gIdxK) = std::min(gIdxJMap.at(gIdxK), wgt);
+                            }
+                        }
+                    }
+                });
 
             return g;
-        }()
-    };
-    
-    finder.pathFinderGlobal(pathM, distM, g);
+        }();
+
+    gNxts.resize(gIdx);
+
+    // the hierarchy stands in for the matrix; the nearest exits come off
+    // a single sweep from all of them
+    if (hFlg)
+    {
+        hier = Hierarchy { gGrph };
+
+        std::vector<CrdType> dist;
+        std::vector<IdxType> near;
+
+        hier.sweep(gEIds, dist, & near);
+
+        gShrts.resize(gIdx);
+
+        for (IdxType i {}; i < gIdx; i++)
+        {
+            gShrts[i] = { near[i], dist[i] };
+            gNxts [i] = hier.nextHop(i, near[i]);
+        }
+
+        return;
+    }
+
+    distM.resize(gIdx * gIdx);
+    pathM.resize(gIdx * gIdx);
+
+    finder.pathFinderGlobal(pathM, distM, gGrph);
 
 	IdxType const xSize { gIdx                               };
 	IdxType const ySize { static_cast<IdxType>(gEIds.size()) };
 
     distMCS.resize(xSize * ySize);
+    gShrts .resize(xSize        );
 
-    for (IdxType j {}; j < ySize; j++)
-    {
-        auto const J { gEIds[j] };
-
-        for (IdxType i {}; i < xSize; i++)
-            distMCS[i * ySize + j] = distM[i * xSize + J];
-    }
     /* keeping distM for the sake of prospective extensions */
     // distM.clear();
-    
-	gShrts.reserve(xSize);
 
-	for (IdxType i {}; i < xSize; i++)
-    {
-		auto const itr
+    spawnBlocks(NTD, xSize, BLK,
+        [this, xSize, ySize] (IdxType bgn, IdxType end)
+        {
+            for (IdxType i { bgn }; i < end; i++)
             {
-                std::min_element(distMCS.cbegin() + (i + 0) * ySize,
-                                 distMCS.cbegin() + (i + 1) * ySize )
-            };
+                auto const row { distMCS.begin() + i * ySize };
 
-		gShrts.push_back(
-            {
-                gEIds[std::distance(distMCS.cbegin() + i * ySize, itr)], * itr
-            });
-	}
+                for (IdxType j {}; j < ySize; j++)
+                    row[j] = distM[i * xSize + gEIds[j]];
+
+                auto const itr { std::min_element(row, row + ySize) };
+
+                gShrts[i] = { gEIds[std::distance(row, itr)], * itr };
+                gNxts [i] = pathM[i * xSize + gShrts[i].first];
+            }
+        });
 }
 
 
@@ -526,30 +1129,31 @@ Router::populateNexts()
 {
 	auto const & nosoz { geometry.getNosoz() };
 
+    nextz .resize(nosoz.size());
     lShrtz.resize(nosoz.size());
 
-	for (IdxType i {}; i < nosoz.size(); i++)
-    {
-		auto const & nosos { nosoz[i] };
-
-        lShrtz[i].resize(nosos.size());
-
-		std::vector<DuoType> next;
-		next.reserve(nosos.size());
+    /* a cell only writes its own next lines and distances */
+    spawnBlocks(NTD, nosoz.size(), BLK,
+        [this, & nosoz] (IdxType bgn, IdxType end)
+        {
+            for (IdxType i { bgn }; i < end; i++)
+            {
+                auto const xSize { nosoz[i].size() };
 
-		for (IdxType j {}; j < nosos.size(); j++)
-			next.push_back(nextMark(i, j));
+                lShrtz[i].resize(xSize);
 
-        next.shrink_to_fit();
-		nextz.emplace_back(std::move(next));
-	}
+                auto & next { nextz[i] };
+                next.reserve(xSize);
 
-	nextz.shrink_to_fit();
+                for (IdxType j {}; j < xSize; j++)
+                    next.push_back(nextMark(i, j));
+            }
+        });
 }
 
 
 DuoType
-Router::nextMark(IdxType cIdx, IdxType sIdx) noexcept
+Router::nextMark(IdxType cIdx, IdxType sIdx) const noexcept
 {
     /* indices of the next global destination (tentative values) */
 	IdxType cIdxD { cIdx };
@@ -560,16 +1164,29 @@ Router::nextMark(IdxType cIdx, IdxType sIdx) noexcept
 	
     auto ySize { susoMap.size() };
 
+    /* a blocked line is routed as any other line of the cell */
     [[ unlikely ]]
-	if (geometry.isSubsolid(cIdxD, sIdx))
+	if (geometry.isSubsolid(cIdxD, sIdx) and (not blocked(cIdxD, sIdx)))
     {
         [[ unlikely ]]
         if (geometry.andIsExit(cIdxD, sIdx))
+        {
+            lShrtz[cIdx][sIdx] = 0.;
+
             return { cIdxD, sIdx };
+        }
 
 		auto const gIdxS { gIdz[cIdxD][susoMap.at(sIdx).sIdx] };
-		auto const gIdxT { gShrts[gIdxS].first                };
-		auto const gIdxD { pathM[gIdxS * gIdx + gIdxT]        };
+		auto const gIdxD { gNxts[gIdxS]                       };
+
+        /* cut off from every exit (see 'block') */
+        [[ unlikely ]]
+        if (gIdxD == IdxTypeMax)
+        {
+            lShrtz[cIdx][sIdx] = std::numeric_limits<CrdType>::infinity();
+
+            return { cIdx, sIdx };
+        }
 
         lShrtz[cIdx][sIdx] = gShrts[gIdxD].second;
         
@@ -591,8 +1208,8 @@ Router::nextMark(IdxType cIdx, IdxType sIdx) noexcept
             }
             else                       /* otherwise, the local shortest path */
             {                          /* may pass through the /other/ cell  */
-                auto const dstS { distMCSs[cIdxD    ][sIdx      * ySize        + susoMap.at(quad.sIdxP).sIdx] };
-                auto const dstO { distMCSs[trio.cIdx][trio.oIdx * susoA.size() + susoA  .at(quad.sIdxS).sIdx] };
+                auto const dstS { distMCSAt(cIdxD    , sIdx     , susoMap.at(quad.sIdxP).sIdx) };
+                auto const dstO { distMCSAt(trio.cIdx, trio.oIdx, susoA  .at(quad.sIdxS).sIdx) };
 
                 // if (fELess(dstS, dstO))
                 if (dstS < dstO)
@@ -612,8 +1229,8 @@ Router::nextMark(IdxType cIdx, IdxType sIdx) noexcept
             }
             else                       /* otherwise, the local shortest path */
             {                          /* may pass through the /other/ cell  */
-                auto const dstS { distMCSs[cIdxD    ][sIdx      * ySize        + susoMap.at(quad.sIdxS).sIdx] };
-                auto const dstO { distMCSs[trio.cIdx][trio.oIdx * susoA.size() + susoA  .at(quad.sIdxP).sIdx] };
+                auto const dstS { distMCSAt(cIdxD    , sIdx     , susoMap.at(quad.sIdxS).sIdx) };
+                auto const dstO { distMCSAt(trio.cIdx, trio.oIdx, susoA  .at(quad.sIdxP).sIdx) };
 
                 // if (fELess(dstS, dstO))
                 if (dstS < dstO)
@@ -642,65 +1259,838 @@ Router::nextMark(IdxType cIdx, IdxType sIdx) noexcept
 		std::vector<CrdType> dist;
 		dist.reserve(ySize);
 
-		auto const & distMCST { distMCSs[cIdxD] };
-
 		for (IdxType i {}; i < ySize; i++)
-			dist.push_back(distMCST[sIdx * ySize + i] + gShrts[gIdz[cIdxD][i]].second);
+			dist.push_back(distMCSAt(cIdxD, sIdx, i) + gShrts[gIdz[cIdxD][i]].second);
 
 		auto const itr { std::min_element(dist.cbegin(), dist.cend()) };
 
 		sIdxD = static_cast<IdxType>(std::distance(dist.cbegin(), itr));
 
         lShrtz[cIdx][sIdx] = * itr;
+
+        [[ unlikely ]]
+        if (std::isinf(* itr))
+            return { cIdx, sIdx };
 	}
 
-	IdxType sIdxM { pathMCSs[cIdxD][sIdx * ySize + sIdxD] };
+	IdxType sIdxM { pathMCSAt(cIdxD, sIdx, sIdxD) };
         
 	return { cIdxD, sIdxM };
 }
 
 
+CrdType
+Router::distMCSAt(IdxType cIdx, IdxType sIdx, IdxType col) const noexcept
+{
+    auto const   tIdx  { geometry.getTmplz   ()[cIdx]        };
+    auto const & perm  { geometry.getPermz   ()[cIdx]        };
+    auto const   ySize { geometry.getSusoExtz()[cIdx].size() };
+
+    col = perm.empty() ? col : perm[col];
+
+    if (lFlg)
+        if (auto const & susoMap { geometry.getSusoMaps()[tIdx] }; susoMap.contains(sIdx))
+            return distIMs[tIdx][susoMap.at(sIdx).sIdx * ySize + col];
+
+    return distMCSs[tIdx][sIdx * ySize + col];
+}
+
+
+IdxType
+Router::pathMCSAt(IdxType cIdx, IdxType sIdx, IdxType col) const noexcept
+{
+    auto const   tIdx  { geometry.getTmplz   ()[cIdx]        };
+    auto const & perm  { geometry.getPermz   ()[cIdx]        };
+    auto const   ySize { geometry.getSusoExtz()[cIdx].size() };
+
+    col = perm.empty() ? col : perm[col];
+
+    if (lFlg)
+        if (auto const & susoMap { geometry.getSusoMaps()[tIdx] }; susoMap.contains(sIdx))
+            return pathIMs[tIdx][susoMap.at(sIdx).sIdx * ySize + col];
+
+    return pathMCSs[tIdx][sIdx * ySize + col];
+}
+
+
 void
-Router::subtractInfc(PseudoType & pseudoz,
-                     IdxType      cIdxP  ,
-                     IdxType      sIdxP  ) const noexcept
+Router::ensure(IdxType cIdx) const
 {
-    auto const & susoExtz { geometry.getSusoExtz() };
+    if ((not lFlg) or kFlg)
+        return;
+
+    std::call_once(nxtOnce[cIdx],
+        [this, cIdx]
+        {
+            auto const tIdx { geometry.getTmplz()[cIdx] };
+
+            std::call_once(mcsOnce[tIdx], [this, tIdx] { finder.findLocal(pathMCSs, distMCSs, tIdx); });
+
+            auto const xSize { geometry.getNosoz()[cIdx].size() };
+
+            lShrtz[cIdx].resize(xSize);
+
+            auto & next { nextz[cIdx] };
+            next.reserve(xSize);
+
+            for (IdxType j {}; j < xSize; j++)
+                next.push_back(nextMark(cIdx, j));
+        });
+}
+
+
+DuoType
+Router::next(IdxType cIdx, IdxType sIdx) const
+{
+    if (auto const * snap { snapP.load(std::memory_order_acquire) })
+        return snap->nexts[snap->offs[cIdx] + sIdx];
+
+    if (kFlg)
+    {
+        auto const & duo { gNexts[gOffs[cIdx] + sIdx] };
+
+        return { duo.cIdx, duo.sIdx };
+    }
+
+    ensure(cIdx);
+
+    return nextz[cIdx][sIdx];
+}
+
+
+CrdType
+Router::lShrt(IdxType cIdx, IdxType sIdx) const
+{
+    if (auto const * snap { snapP.load(std::memory_order_acquire) })
+        return snap->shrts[snap->offs[cIdx] + sIdx];
+
+    if (kFlg)
+        return gShrtz[gOffs[cIdx] + sIdx];
+
+    ensure(cIdx);
+
+    return lShrtz[cIdx][sIdx];
+}
+
+
+/**
+ * Takes the distances off the global matrix, a column per target, or
+ * the hierarchy; the matrix is kept for this, hence the fields of a
+ * compact router are null. Neither knows of the blocked lines: with any,
+ * the field is formed by a search around them, as a snapshot is
+ */
+std::shared_ptr<Router::FieldType const>
+Router::field(std::span<DuoType const> trgts) const
+{
+    if (kFlg)
+        return {};
+
     auto const & susoMaps { geometry.getSusoMaps() };
 
-    auto const & blobP { geometry.getBlob(cIdxP, sIdxP) };
+    std::vector<IdxType> tgts;
+    tgts.reserve(trgts.size());
 
-    if (pseudoz.contains(cIdxP))
-        for (auto const sIdx : blobP)
-            pseudoz[cIdxP].erase(sIdx);
-    else
+    for (auto const & [cIdx, sIdx] : trgts)
     {
-        pseudoz[cIdxP] = {};
-        
-        for (auto const & trio : susoExtz[cIdxP])
-            pseudoz[cIdxP].insert(trio.sIdx);
-        
-        for (auto const sIdx : blobP)
-            pseudoz[cIdxP].erase(sIdx);
+        auto const itr { susoMaps[cIdx].find(sIdx) };
+
+        if (itr == susoMaps[cIdx].cend())
+            return {};
+
+        tgts.push_back(gIdz[cIdx][itr->second.sIdx]);
     }
-    
-    auto const & [_, cIdxS, sIdxS] { susoMaps[cIdxP].at(sIdxP) };
 
-    auto const & blobS { geometry.getBlob(cIdxS, sIdxS) };
-    
-    if (pseudoz.contains(cIdxS))
-        for (auto const sIdx : blobS)
-            pseudoz[cIdxS].erase(sIdx);
+    std::sort(tgts.begin(), tgts.end());
+    tgts.erase(std::unique(tgts.begin(), tgts.end()), tgts.end());
+
+    auto const cached
+    {
+        [this, & tgts] () -> std::shared_ptr<FieldType const>
+        {
+            auto const itr { std::find_if(flds.cbegin(), flds.cend(),
+                                          [& tgts] (auto const & f) { return f->tgts == tgts; }) };
+
+            if (itr == flds.cend())
+                return {};
+
+            flds.splice(flds.cbegin(), flds, itr);
+
+            return flds.front();
+        }
+    };
+
+    {
+        std::unique_lock const lock { fldM };
+
+        if (auto fld { cached() })
+            return fld;
+    }
+
+    /* formed unlocked; another thread may form the same field meanwhile */
+    auto fld { std::make_shared<FieldType>() };
+
+    if (std::find(gBlks.cbegin(), gBlks.cend(), true) != gBlks.cend())
+    {
+        fld->tgts = tgts;
+
+        spread(* fld, gBlks, [] (IdxType) { return CrdType {}; });
+    }
+    else if (hFlg)
+        hier.sweep(tgts, fld->dist);
     else
     {
-        pseudoz[cIdxS] = {};
-        
-        for (auto const & trio : susoExtz[cIdxS])
-            pseudoz[cIdxS].insert(trio.sIdx);
-        
-        for (auto const sIdx : blobS)
-            pseudoz[cIdxS].erase(sIdx);
+        fld->dist.assign(gIdx, std::numeric_limits<CrdType>::infinity());
+
+        for (IdxType i {}; i < gIdx; i++)
+            for (auto const t : tgts)
+                fld->dist[i] = std::min(fld->dist[i], distM[i * gIdx + t]);
+    }
+
+    fld->tgts = std::move(tgts);
+
+    std::unique_lock const lock { fldM };
+
+    if (auto fldC { cached() })
+        return fldC;
+
+    flds.push_front(std::move(fld));
+
+    if (flds.size() > FLD)
+        flds.pop_back();
+
+    return flds.front();
+}
+
+
+CrdType
+Router::distance(DuoType lineA, DuoType lineB) const
+{
+    auto const gIdxA { global(lineA) };
+    auto const gIdxB { global(lineB) };
+
+    if ((gIdxA == IdxTypeMax) or (gIdxB == IdxTypeMax))
+        return std::numeric_limits<CrdType>::infinity();
+
+    if (std::find(gBlks.cbegin(), gBlks.cend(), true) != gBlks.cend())
+        return detour(gIdxA, gIdxB).first;
+
+    return hFlg ? hier.distance(gIdxA, gIdxB) : distM[gIdxA * gIdx + gIdxB];
+}
+
+
+DuoType
+Router::nextHop(DuoType lineA, DuoType lineB) const
+{
+    auto const gIdxA { global(lineA) };
+    auto const gIdxB { global(lineB) };
+
+    if ((gIdxA == IdxTypeMax) or (gIdxB == IdxTypeMax))
+        return lineA;
+
+    auto const gIdxD
+    {
+        std::find(gBlks.cbegin(), gBlks.cend(), true) != gBlks.cend() ? detour(gIdxA, gIdxB).second :
+        hFlg                                                            ? hier.nextHop(gIdxA, gIdxB)      :
+                                                                          pathM[gIdxA * gIdx + gIdxB]
+    };
+
+    if (gIdxD == IdxTypeMax)
+        return lineA;
+
+    return { quads[gIdxD].cIdxP, quads[gIdxD].sIdxP };
+}
+
+
+// a search from 'gIdxA' that ends at 'gIdxB', keeping the first line
+// taken to each; a blocked line is neither passed nor reached
+std::pair<CrdType, IdxType>
+Router::detour(IdxType gIdxA, IdxType gIdxB) const
+{
+    auto constexpr INF { std::numeric_limits<CrdType>::infinity() };
+
+    if (gBlks[gIdxA] or gBlks[gIdxB])
+        return { INF, IdxTypeMax };
+
+    if (gIdxA == gIdxB)
+        return { CrdType {}, IdxTypeMax };
+
+    std::vector<CrdType> dist(gIdx, INF       );
+    std::vector<IdxType> frst(gIdx, IdxTypeMax);
+
+    std::priority_queue<NbrType, std::vector<NbrType>, std::greater<NbrType>> q;
+
+    dist[gIdxA] = 0;
+    q.push({ CrdType {}, gIdxA });
+
+    while (not q.empty())
+    {
+        auto const [du, u] { q.top() };
+        q.pop();
+
+        if (u == gIdxB)
+            return { du, frst[u] };
+
+        if (du > dist[u])
+            continue;
+
+        for (auto const & [v, w] : gGrph[u])
+        {
+            if (gBlks[v])
+                continue;
+
+            if (auto const dv { du + w }; dv < dist[v])
+            {
+                dist[v] = dv;
+                frst[v] = (u == gIdxA) ? v : frst[u];
+
+                q.push({ dv, v });
+            }
+        }
     }
+
+    return { INF, IdxTypeMax };
+}
+
+
+IdxType
+Router::global(DuoType line) const noexcept
+{
+    if (kFlg)
+        return IdxTypeMax;
+
+    auto const & susoMap { geometry.getSusoMaps()[line.cIdx] };
+
+    auto const itr { susoMap.find(line.sIdx) };
+
+    return itr == susoMap.cend() ? IdxTypeMax : gIdz[line.cIdx][itr->second.sIdx];
+}
+
+
+bool
+Router::blocked(IdxType cIdx, IdxType sIdx) const noexcept
+{
+    if (gBlks.empty())
+        return false;
+
+    auto const gIdxL { global({ cIdx, sIdx }) };
+
+    return (gIdxL != IdxTypeMax) and gBlks[gIdxL];
+}
+
+
+bool
+Router::isExit(IdxType cIdx, IdxType sIdx) const noexcept
+{
+    return geometry.isExit(cIdx, sIdx) and (not blocked(cIdx, sIdx));
+}
+
+
+std::optional<std::string>
+Router::block(std::span<DuoType const> lines, bool blkd)
+{
+    if (kFlg)
+        return "a compact router cannot be rerouted";
+
+    std::vector<IdxType> gIds;
+
+    for (auto const & line : lines)
+    {
+        auto const gIdxL { global(line) };
+
+        if (gIdxL == IdxTypeMax)
+            return fmt::format("line {} of cell {} is not subsolid", line.sIdx, line.cIdx);
+
+        gIds.push_back(gIdxL);
+    }
+
+    /* only the lines that change state */
+    std::erase_if(gIds, [this, blkd] (IdxType g) { return ((not gBlks.empty()) and gBlks[g]) == blkd; });
+
+    std::sort(gIds.begin(), gIds.end());
+    gIds.erase(std::unique(gIds.begin(), gIds.end()), gIds.end());
+
+    if (gIds.empty())
+        return {};
+
+    /* a snapshot being formed reads the blocked lines */
+    std::unique_lock const lock { blkM };
+
+    blks++;
+
+    if (gBlks.empty())
+        gBlks.resize(gIdx);
+
+    for (auto const g : gIds)
+        gBlks[g] = blkd;
+
+    std::vector<IdxType> chgd { gIds };
+
+    if (blkd)
+        detach(gIds, chgd);
+    else
+        attach(gIds, chgd);
+
+    // the next lines and exit distances of a cell only draw on its own
+    // global lines; those of the cells of the changed ones are formed again
+    // (a lazy router forms the rest on their first use, as ever)
+    std::vector<IdxType> cIdz;
+
+    for (auto const g : chgd)
+        for (auto const c : { quads[g].cIdxP, quads[g].cIdxS })
+            if (c != IdxTypeMax)
+                cIdz.push_back(c);
+
+    std::sort(cIdz.begin(), cIdz.end());
+    cIdz.erase(std::unique(cIdz.begin(), cIdz.end()), cIdz.end());
+
+    auto const & nosoz { geometry.getNosoz() };
+
+    spawnBlocks(NTD, cIdz.size(), BLK,
+        [this, & cIdz, & nosoz] (IdxType bgn, IdxType end)
+        {
+            for (IdxType i { bgn }; i < end; i++)
+            {
+                auto const c { cIdz[i] };
+
+                auto & next { nextz[c] };
+
+                for (IdxType j {}; j < next.size(); j++)
+                    next[j] = nextMark(c, j);
+            }
+        });
+
+    /* formed before, it routes through the lines blocked */
+    if (snapC)
+        publish({});
+
+    /* as are the fields kept */
+    {
+        std::unique_lock const fldL { fldM };
+
+        flds.clear();
+    }
+
+    rts++;
+
+    return {};
+}
+
+
+// the routes to the nearest exit form a forest over the global graph,
+// rooted at the exits ('gNxts'); blocking lines cuts off their subtrees,
+// whose lines are then routed again, off the rest (which keep their
+// routes), by a search confined to the subtrees
+void
+Router::detach(std::span<IdxType const> gIds, std::vector<IdxType> & chgd)
+{
+    auto constexpr INF { std::numeric_limits<CrdType>::infinity() };
+
+    std::vector<bool> cut(gIdx);
+
+    std::vector<IdxType> subs { gIds.begin(), gIds.end() };
+
+    for (auto const g : subs)
+        cut[g] = true;
+
+    /* the subtrees: a neighbour routed through a line is its child */
+    for (IdxType i {}; i < subs.size(); i++)
+    {
+        auto const u { subs[i] };
+
+        for (auto const & [v, w] : gGrph[u])
+            if ((not cut[v]) and (gNxts[v] == u))
+            {
+                cut[v] = true;
+                subs.push_back(v);
+            }
+    }
+
+    for (auto const v : subs)
+    {
+        gShrts[v] = { IdxTypeMax, INF };
+        gNxts [v] = IdxTypeMax;
+    }
+
+    std::priority_queue<NbrType, std::vector<NbrType>, std::greater<NbrType>> q;
+
+    /* the open lines of the subtrees, from their neighbours outside */
+    for (auto const v : subs)
+    {
+        if (gBlks[v])
+            continue;
+
+        for (auto const & [u, w] : gGrph[v])
+        {
+            if (cut[u] or gBlks[u] or std::isinf(gShrts[u].second))
+                continue;
+
+            if (auto const dv { gShrts[u].second + gGrph[u].at(v) }; dv < gShrts[v].second)
+            {
+                gShrts[v] = { gShrts[u].first, dv };
+                gNxts [v] = u;
+            }
+        }
+
+        if (not std::isinf(gShrts[v].second))
+            q.push({ gShrts[v].second, v });
+    }
+
+    while (not q.empty())
+    {
+        auto const [du, u] { q.top() };
+        q.pop();
+
+        if (du > gShrts[u].second)
+            continue;
+
+        for (auto const & [v, w] : gGrph[u])
+        {
+            if ((not cut[v]) or gBlks[v])
+                continue;
+
+            if (auto const dv { du + w }; dv < gShrts[v].second)
+            {
+                gShrts[v] = { gShrts[u].first, dv };
+                gNxts [v] = u;
+
+                q.push({ dv, v });
+            }
+        }
+    }
+
+    chgd.insert(chgd.end(), subs.begin() + gIds.size(), subs.end());
+}
+
+
+// reopened lines can only shorten routes; they are routed off their
+// neighbours (or are roots, if exits), and the routes they shorten are
+// spread outwards, as far as they reach
+void
+Router::attach(std::span<IdxType const> gIds, std::vector<IdxType> & chgd)
+{
+    std::priority_queue<NbrType, std::vector<NbrType>, std::greater<NbrType>> q;
+
+    for (auto const r : gIds)
+    {
+        /* an EXIT line is owned by its only cell */
+        if (quads[r].cIdxS == IdxTypeMax)
+        {
+            gShrts[r] = { r, 0. };
+            gNxts [r] = r;
+        }
+        else
+            for (auto const & [u, w] : gGrph[r])
+            {
+                if ((u == r) or gBlks[u] or std::isinf(gShrts[u].second))
+                    continue;
+
+                if (auto const dr { gShrts[u].second + gGrph[u].at(r) }; dr < gShrts[r].second)
+                {
+                    gShrts[r] = { gShrts[u].first, dr };
+                    gNxts [r] = u;
+                }
+            }
+
+        if (not std::isinf(gShrts[r].second))
+            q.push({ gShrts[r].second, r });
+    }
+
+    while (not q.empty())
+    {
+        auto const [du, u] { q.top() };
+        q.pop();
+
+        if (du > gShrts[u].second)
+            continue;
+
+        for (auto const & [v, w] : gGrph[u])
+        {
+            if (gBlks[v])
+                continue;
+
+            if (auto const dv { du + w }; dv < gShrts[v].second)
+            {
+                gShrts[v] = { gShrts[u].first, dv };
+                gNxts [v] = u;
+
+                chgd.push_back(v);
+                q.push({ dv, v });
+            }
+        }
+    }
+}
+
+
+template <typename P>
+void
+Router::spread(FieldType & fld, std::vector<bool> const & shut, P const & pnlt) const
+{
+    auto const blkd { [& shut] (IdxType g) { return (not shut.empty()) and shut[g]; } };
+
+    fld.dist.assign(gIdx, std::numeric_limits<CrdType>::infinity());
+
+    std::priority_queue<NbrType, std::vector<NbrType>, std::greater<NbrType>> q;
+
+    for (auto const t : fld.tgts)
+    {
+        if (blkd(t))
+            continue;
+
+        fld.dist[t] = pnlt(t);
+
+        q.push({ fld.dist[t], t });
+    }
+
+    while (not q.empty())
+    {
+        auto const [du, u] { q.top() };
+        q.pop();
+
+        if (du > fld.dist[u])
+            continue;
+
+        for (auto const & [v, w] : gGrph[u])
+        {
+            if (blkd(v))
+                continue;
+
+            if (auto const dv { du + w + pnlt(v) }; dv < fld.dist[v])
+            {
+                fld.dist[v] = dv;
+
+                q.push({ dv, v });
+            }
+        }
+    }
+}
+
+
+// the routes to the open exits, by a search from all of them at once,
+// where passing a line costs the penalties of its cells on top; the
+// search makes a field of them, so that each line goes on as it would
+// towards a set of targets (see 'fieldMark')
+std::shared_ptr<Router::SnapType const>
+Router::snapshot(std::span<CrdType const> pnlz) const
+{
+    if (kFlg)
+        return {};
+
+    // the blocked lines as of now, taken under the lock so that 'block'
+    // waits on the copy only, not on the search
+    std::vector<bool> gBlksC;
+    IdxType           blksC {};
+
+    {
+        std::unique_lock const lock { blkM };
+
+        gBlksC = gBlks;
+        blksC  = blks ;
+    }
+
+    auto const pnlt
+    {
+        [this, pnlz] (IdxType g)
+        {
+            auto const & quad { quads[g] };
+
+            return pnlz[quad.cIdxP] + (quad.cIdxS == IdxTypeMax ? CrdType {} : pnlz[quad.cIdxS]);
+        }
+    };
+
+    FieldType fld;
+
+    for (auto const e : gEIds)
+        if (gBlksC.empty() or (not gBlksC[e]))
+            fld.tgts.push_back(e);
+
+    spread(fld, gBlksC, pnlt);
+
+    std::sort(fld.tgts.begin(), fld.tgts.end());
+
+    auto const & nosoz { geometry.getNosoz() };
+
+    auto snap { std::make_shared<SnapType>() };
+
+    snap->offs.reserve(nosoz.size() + 1);
+
+    for (IdxType i {}; i < nosoz.size(); i++)
+    {
+        snap->offs.push_back(snap->nexts.size());
+
+        for (IdxType j {}; j < nosoz[i].size(); j++)
+        {
+            auto const [next, dist] { fieldMark(fld, i, j, gBlksC) };
+
+            snap->nexts.push_back(next);
+            snap->shrts.push_back(dist);
+        }
+    }
+    snap->offs.push_back(snap->nexts.size());
+
+    snap->blks = blksC;
+
+    return snap;
+}
+
+
+// readers load the pointer once per query and hold nothing past the
+// step, so the snapshot replaced is free once the workers have met at
+// the barrier that ends it; it is released a step later all the same
+void
+Router::publish(std::shared_ptr<SnapType const> snap)
+{
+    if ((not snap) and (not snapC))
+        return;
+
+    /* formed before a 'block', it routes through the lines blocked */
+    if (snap and (snap->blks != blks))
+        return;
+
+    snapP.store(snap.get(), std::memory_order_release);
+
+    snapR = std::exchange(snapC, std::move(snap));
+
+    rts++;
+}
+
+
+void
+Router::reclaim() noexcept
+{
+    snapR.reset();
+}
+
+
+DuoType
+Router::next(FieldType const & fld, IdxType cIdx, IdxType sIdx) const
+{
+    return fieldMark(fld, cIdx, sIdx, gBlks).first;
+}
+
+
+CrdType
+Router::lShrt(FieldType const & fld, IdxType cIdx, IdxType sIdx) const
+{
+    return fieldMark(fld, cIdx, sIdx, gBlks).second;
+}
+
+
+// as 'nextMark', with the field in place of the exit distances; a target
+// is its own next line, and a subsolid line may go on from either side
+std::pair<DuoType, CrdType>
+Router::fieldMark(FieldType const & fld, IdxType cIdx, IdxType sIdx, std::vector<bool> const & shut) const
+{
+    auto const & susoMap { geometry.getSusoMaps()[cIdx] };
+
+    /* the line, and its dual in the adjacent cell */
+    std::array<DuoType, 2> orgs { DuoType { cIdx, sIdx }, DuoType { IdxTypeMax, IdxTypeMax } };
+
+    IdxType gIdxS { IdxTypeMax };
+
+    if (auto const itr { susoMap.find(sIdx) }; itr != susoMap.cend())
+    {
+        gIdxS = gIdz[cIdx][itr->second.sIdx];
+
+        auto const blkd { (not shut.empty()) and shut[gIdxS] };
+
+        if (std::binary_search(fld.tgts.cbegin(), fld.tgts.cend(), gIdxS) and (not blkd))
+            return { { cIdx, sIdx }, 0 };
+
+        /* a blocked line is routed within its own cell, as in 'nextMark' */
+        if ((itr->second.cIdx != cIdx) and (not blkd))
+            orgs[1] = { itr->second.cIdx, itr->second.oIdx };
+    }
+
+    DuoType orgD { cIdx, sIdx };
+    IdxType colD { IdxTypeMax };
+    CrdType dstD { std::numeric_limits<CrdType>::infinity() };
+
+    for (auto const & org : orgs)
+    {
+        if (org.cIdx == IdxTypeMax)
+            continue;
+
+        ensure(org.cIdx);
+
+        auto const & gIds { gIdz[org.cIdx] };
+
+        for (IdxType k {}; k < gIds.size(); k++)
+        {
+            if (gIds[k] == gIdxS)
+                continue;
+
+            auto const dst { distMCSAt(org.cIdx, org.sIdx, k) + fld.dist[gIds[k]] };
+
+            if (dst < dstD)
+            {
+                orgD = org;
+                colD = k;
+                dstD = dst;
+            }
+        }
+    }
+
+    /* no target is reachable */
+    [[ unlikely ]]
+    if (colD == IdxTypeMax)
+        return { { cIdx, sIdx }, dstD };
+
+    return { { orgD.cIdx, pathMCSAt(orgD.cIdx, orgD.sIdx, colD) }, dstD };
+}
+
+
+DctType const &
+Router::dct(IdxType cIdxP, IdxType cIdxS) const noexcept
+{
+    if (not kFlg)
+        return dcts[cIdxP].at(cIdxS);
+
+    auto const itr
+    {
+        std::lower_bound(gDcts.cbegin() + dOffs[cIdxP    ],
+                         gDcts.cbegin() + dOffs[cIdxP + 1], cIdxS,
+                         [] (auto const & p, IdxType k) { return p.first < k; })
+    };
+
+    return itr->second;
+}
+
+
+std::pair<IdxType, IdxType>
+Router::subtractInfc(PseudoType & pseudoz,
+                     IdxType      cIdxP  ,
+                     IdxType      sIdxP  ,
+                     IdxType      setP   ) const
+{
+    auto const & susoExtz { geometry.getSusoExtz() };
+    auto const & susoMaps { geometry.getSusoMaps() };
+
+    auto const subtract
+    {
+        [& pseudoz, & susoExtz] (IdxType cIdx, IdxType set, BlobType const & blob)
+        {
+            if (set == PseudoType::NONE)
+                set = pseudoz.find(cIdx);
+
+            if (set == PseudoType::NONE)
+            {
+                set = pseudoz.add(cIdx);
+
+                for (auto const & trio : susoExtz[cIdx])
+                    pseudoz[set].push_back(trio.sIdx);
+            }
+
+            std::erase_if(pseudoz[set], [& blob] (IdxType sIdx) { return std::find(blob.cbegin(), blob.cend(), sIdx) != blob.cend(); });
+
+            return set;
+        }
+    };
+
+    setP = subtract(cIdxP, setP, geometry.getBlob(cIdxP, sIdxP));
+    
+    auto const & [_, cIdxS, sIdxS] { susoMaps[cIdxP].at(sIdxP) };
+
+    return { setP, subtract(cIdxS, PseudoType::NONE, geometry.getBlob(cIdxS, sIdxS)) };
 }
 
 
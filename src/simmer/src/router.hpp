@@ -25,11 +25,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <list>
+
 #include "geometry.hpp"
-#include "spawner.hpp"
+#include "hierarchy.hpp"
 
 
-using Navi = std::tuple<std::vector<smr::Line>, std::vector<DuoType>>;
+using Navi     = std::tuple<std::vector<smr::Line>        , std::vector<DuoType>        >;
+using NaviView = std::tuple<std::span<smr::Line const>, std::span<DuoType const>>;
 
 class Finder;
 
@@ -40,15 +44,89 @@ public:
              Router() = delete;
     virtual ~Router() = default;
     
-    Router(Geometry const & geometry, Finder const & finder);
+    // lazy mode ('lFlg') builds only the global graph up front; the
+    // local matrices and next lines of a cell follow on its first use;
+    // 'hFlg' indexes the global graph with a contraction hierarchy in
+    // place of the all-pairs matrix
+    Router(Geometry const & geometry, Finder const & finder, bool lFlg = false, bool hFlg = false);
+
+    /* takes over local matrices formed ahead (see 'Geometry::mFlg') */
+    Router(Geometry const & geometry, Finder const & finder, MCSsType && mcss, bool hFlg = false);
+
+    /* pseudo-walls of the cells on a route; flat, to keep their storage */
+    struct PseudoType
+    {
+        static IdxType constexpr NONE { IdxTypeMax };
+
+        std::vector<std::pair<IdxType, std::vector<IdxType>>> sets;
+
+        IdxType size {};  /* entries in use */
+
+        void clear() noexcept { size = 0; }
+
+        /* index of the set of 'cIdx', or 'NONE'; a scan, so a route keeps those of its cells */
+        IdxType
+        find(IdxType cIdx) const noexcept
+        {
+            for (IdxType i {}; i < size; i++)
+                if (sets[i].first == cIdx)
+                    return i;
+
+            return NONE;
+        }
+
+        IdxType
+        add(IdxType cIdx)
+        {
+            if (size == sets.size())
+                sets.emplace_back();
+
+            auto & [c, set] { sets[size] };
+
+            c = cIdx;
+            set.clear();
+
+            return size++;
+        }
+
+        std::vector<IdxType> &
+        operator[](IdxType i) noexcept { return sets[i].second; }
+
+        std::span<IdxType const>
+        view(IdxType i) const noexcept
+        {
+            return (i == NONE) ? std::span<IdxType const> {} : std::span<IdxType const> { sets[i].second };
+        }
+    };
+
+    // buffers of the queries, reused from one to the next so that a warm
+    // one does not allocate; one per thread
+    struct ScratchType
+    {
+        std::vector<DuoType>    cells  ;
+        std::vector<smr::Point> tails  ;
+        std::vector<IdxType>    setz   ;  /* of 'pseudoz', per cell of 'cells' */
+        std::vector<std::pair<CrdType, CrdType>> gaps;  /* of the funnel, per cell of 'cells' (see 'findVisible') */
+        std::vector<smr::Line>  lines  ;
+        std::vector<smr::Line>  linesT ;
+        std::vector<smr::Point> ends   ;
+        PseudoType              pseudoz;
+
+        /* of 'findLine' */
+        std::vector<IdxType> vec;
+        std::vector<CrdType> dst;
+    };
 
     IdxType
-    findLine(IdxType cIdx, smr::Point const & pt) const noexcept;
+    findLine(IdxType cIdx, smr::Point const & pt) const;
+
+    IdxType
+    findLine(ScratchType & scr, IdxType cIdx, smr::Point const & pt) const;
     
     std::pair<IdxType, smr::Line>
-    findCell(std::vector<smr::Line> const & lines,
-             std::vector<DuoType>   const & cells,
-             CrdType                const   s    ) const noexcept;
+    findCell(std::span<smr::Line const> lines,
+             std::span<DuoType   const> cells,
+             CrdType              const s    ) const noexcept;
     
     Navi
     findVisible(IdxType            cIdx                  ,
@@ -56,17 +134,116 @@ public:
                 IdxType            hop                   ,
                 CrdType    const   cpa  = smr::Param::CPA) const;
 
+    std::optional<NaviView>
+    findVisible(ScratchType                  & scr                   ,
+                IdxType                        cIdx                  ,
+                smr::Point             const & pt                    ,
+                std::optional<DuoType> const & trgt                  ,
+                IdxType                        hop                   ,
+                CrdType                const   rch  = CrdTypeMax     ,
+                CrdType                const   cpa  = smr::Param::CPA) const;
+
+    /* the lines from 'pt' to the last line of 'cells', as 'findVisible' draws them */
+    NaviView
+    retrace(ScratchType & scr, smr::Point const & pt, std::span<DuoType const> cells) const;
+
     Navi
     findVisibleG(IdxType            cIdx                  ,
                  smr::Point const & pt                    ,
                  IdxType            hop                   ,
                  CrdType    const   cpa  = smr::Param::CPA) const;
 
+    // the next line and the exit distance of a nonsolid line; together,
+    // a flow field over the mesh (see 'FlowActuator')
+    DuoType next (IdxType cIdx, IdxType sIdx) const;
+    CrdType lShrt(IdxType cIdx, IdxType sIdx) const;
+
+    // distances of the global lines to the nearest of a set of target
+    // (subsolid) lines: routes to assigned exits, or assembly points,
+    // rather than to the nearest exit
+    struct FieldType
+    {
+        std::vector<IdxType> tgts;  /* global indices, sorted */
+        std::vector<CrdType> dist;
+    };
+
+    // the field of the target lines, shared; the last 'FLD' fields asked
+    // for are kept, until a 'block'; null for a compact router, or a
+    // target that is not subsolid
+    std::shared_ptr<FieldType const>
+    field(std::span<DuoType const> trgts) const;
+
+    /* as 'next' and 'lShrt', towards the targets of a field */
+    DuoType next (FieldType const & fld, IdxType cIdx, IdxType sIdx) const;
+    CrdType lShrt(FieldType const & fld, IdxType cIdx, IdxType sIdx) const;
+
+    // the distance between two subsolid lines over the global graph, and
+    // the global line next to the first on the way (as a line of its
+    // owning cell), around the blocked lines; infinity (and the line
+    // itself) for a compact router, a line that is not subsolid, or one
+    // cut off
+    CrdType distance(DuoType lineA, DuoType lineB) const;
+    DuoType nextHop (DuoType lineA, DuoType lineB) const;
+
+    // blocks (or reopens) subsolid lines mid-run, eg. doors closed: no
+    // route to the nearest exit passes a blocked line, and a blocked EXIT
+    // is no way out; the exit distances and next lines are repaired only
+    // where they change (fields and 'distance' still see every line), and
+    // a published snapshot is dropped; called between steps, with no query
+    // running (see 'Simmer::HookType'); not for a compact router
+    std::optional<std::string>
+    block(std::span<DuoType const> lines, bool blkd = true);
+
+    /* an EXIT line, not blocked */
+    bool
+    isExit(IdxType cIdx, IdxType sIdx) const noexcept;
+
+    /* 'block' (and 'publish') calls that changed the routes; routes held from before are stale */
+    IdxType reroutes() const noexcept { return rts; }
+
+    // a query-only copy of the next lines and exit distances, with the
+    // cost of passing each global line raised by the penalties of its
+    // cells (eg. crowding); the lines of cell 'c' take up [offs[c],
+    // offs[c+1]) of 'nexts' and 'shrts', as in a compact router
+    struct SnapType
+    {
+        std::vector<IdxType> offs ;
+        std::vector<DuoType> nexts;
+        std::vector<CrdType> shrts;
+
+        /* 'block' calls before it was formed; stale after another */
+        IdxType blks {};
+    };
+
+    // forms a snapshot off the global graph in the calling thread, with a
+    // penalty (a length) per cell; queries may go on meanwhile, and a
+    // 'block' waits for it, after which it is not published; null for a
+    // compact router
+    std::shared_ptr<SnapType const>
+    snapshot(std::span<CrdType const> pnlz) const;
+
+    // the routes 'next' and 'lShrt' read from now on (null: the router's
+    // own); called between steps, with no query running; the snapshot
+    // replaced is retired, and released by the next 'reclaim', once every
+    // thread has passed the barrier
+    void publish(std::shared_ptr<SnapType const> snap);
+    void reclaim() noexcept;
+
     smr::Line
     translate(IdxType cIdxP, IdxType cIdxS, smr::Line const & l) const noexcept;
 
     smr::Point
     translate(IdxType cIdxP, IdxType cIdxS, smr::Point const & p) const noexcept;
+
+    // keeps only what queries need (next lines, exit distances and
+    // dictionaries), in 32-bit form, and releases the rest; a lazy
+    // router forms the remaining cells first
+    std::optional<std::string>
+    compact();
+
+    /* approximate heap footprint of the tables, in bytes */
+    std::size_t
+    footprint() const noexcept;
     
 protected:
 
@@ -76,29 +253,93 @@ protected:
     void populateNexts();
 
     DuoType
-    nextMark(IdxType cIdx, IdxType sIdx) noexcept;
+    nextMark(IdxType cIdx, IdxType sIdx) const noexcept;
+
+    // the next line and the distance of a nonsolid line in a field; a
+    // line of 'shut' (blocked lines, as 'gBlks', or a copy of it) is no
+    // target, and does not go on from the other side
+    std::pair<DuoType, CrdType>
+    fieldMark(FieldType const & fld, IdxType cIdx, IdxType sIdx, std::vector<bool> const & shut) const;
+
+    // the search of 'snapshot' and 'field': distances over the global
+    // graph from the targets of 'fld' not in 'shut', and around those,
+    // passing a line costing 'pnlt' of it on top
+    template <typename P>
+    void
+    spread(FieldType & fld, std::vector<bool> const & shut, P const & pnlt) const;
+
+    // the distance and the next global line from one global line to
+    // another, around the blocked lines, by a search over the global
+    // graph; infinity (and 'IdxTypeMax') if cut off
+    std::pair<CrdType, IdxType>
+    detour(IdxType gIdxA, IdxType gIdxB) const;
+
+    /* the global index of a subsolid line; 'IdxTypeMax' if none */
+    IdxType
+    global(DuoType line) const noexcept;
+
+    bool
+    blocked(IdxType cIdx, IdxType sIdx) const noexcept;
 
-    using PseudoType = std::unordered_map<IdxType, std::unordered_set<IdxType>>;
+    // repair the routes to the nearest exit once lines are blocked
+    // ('detach') or reopened ('attach'); the global lines whose routes
+    // change are added to 'chgd'
+    void detach(std::span<IdxType const> gIds, std::vector<IdxType> & chgd);
+    void attach(std::span<IdxType const> gIds, std::vector<IdxType> & chgd);
 
+    /* makes the local matrices and the next lines of a cell available */
     void
+    ensure(IdxType cIdx) const;
+
+    DctType const &
+    dct(IdxType cIdxP, IdxType cIdxS) const noexcept;
+
+    // entries (line, column) of the local matrices of a cell; a congruent
+    // copy reads those of its template, and in lazy mode subsolid rows
+    // are read off the interface blocks
+    CrdType distMCSAt(IdxType cIdx, IdxType sIdx, IdxType col) const noexcept;
+    IdxType pathMCSAt(IdxType cIdx, IdxType sIdx, IdxType col) const noexcept;
+
+    // the indices of the sets of both cells of the interface, that of
+    // 'cIdxP' given as 'setP' when known
+    std::pair<IdxType, IdxType>
     subtractInfc(PseudoType & pseudoz,
                  IdxType      cIdxP  ,
-                 IdxType      sIdxP  ) const noexcept;
+                 IdxType      sIdxP  ,
+                 IdxType      setP   ) const;
 
     IdxType gIdx {};
     
     Geometry const & geometry;
     Finder   const & finder  ;
 
-    /* local matrices */
-    std::vector<std::vector<IdxType>> pathMCSs;
-    std::vector<std::vector<CrdType>> distMCSs;
+    /* lazy flag */
+    bool const lFlg;
+
+    /* hierarchy flag */
+    bool const hFlg;
+
+    /* local matrices; filled on demand in lazy mode */
+    mutable std::vector<std::vector<IdxType>> pathMCSs;
+    mutable std::vector<std::vector<CrdType>> distMCSs;
+
+    /* interface blocks of the local matrices (lazy mode) */
+    std::vector<std::vector<IdxType>> pathIMs;
+    std::vector<std::vector<CrdType>> distIMs;
+
+    // once-per-cell flags (lazy mode) of the local
+    // matrices (of templates) and the next lines
+    std::unique_ptr<std::once_flag[]> mcsOnce;
+    std::unique_ptr<std::once_flag[]> nxtOnce;
 
     /* global matrix */
     std::vector<IdxType> pathM  ;
     std::vector<CrdType> distM  ;
     std::vector<CrdType> distMCS;
 
+    /* in place of the global matrix ('hFlg') */
+    Hierarchy hier;
+
     std::vector<QudType> quads;
 
     /* global indices ('gIdx') of EXIT lines */
@@ -106,22 +347,74 @@ protected:
 
     std::vector<std::vector<IdxType>> gIdz;
 
+    /* the global graph, kept for rerouting */
+    GraphType gGrph;
+
+    /* the next global line of each on its route to the nearest exit */
+    std::vector<IdxType> gNxts;
+
+    /* blocked global lines; empty until a line is */
+    std::vector<bool> gBlks;
+
+    /* see 'reroutes' */
+    IdxType rts {};
+
     // the distance of the closest EXIT line to a subsolid line;
     // used to speed up finding the shortest exit distance for
     // a nonsolid line in a given cell
     std::vector<std::pair<IdxType, CrdType>> gShrts;
 
     /* the distance of each nonsolid line to the nearest exit */
-    std::vector<std::vector<CrdType>> lShrtz;
+    mutable std::vector<std::vector<CrdType>> lShrtz;
 
     // store the next line on the path of a nonsolid line
     // to nearest exit
-    std::vector<std::vector<DuoType>> nextz;
+    mutable std::vector<std::vector<DuoType>> nextz;
 
     std::vector<std::unordered_map<IdxType, DctType>> dcts;
+
+    /* compact flag */
+    bool kFlg {};
+
+    struct Duo32Type
+    {
+        std::uint32_t cIdx {};
+        std::uint32_t sIdx {};
+    };
+
+    // tables of a compact router; the lines of cell 'c' take up
+    // [gOffs[c], gOffs[c+1]) of 'gNexts' and 'gShrtz', and its
+    // dictionaries [dOffs[c], dOffs[c+1]) of 'gDcts', by key
+    std::vector<std::uint32_t> gOffs ;
+    std::vector<Duo32Type>     gNexts;
+    std::vector<float>         gShrtz;
+
+    std::vector<std::uint32_t>                     dOffs;
+    std::vector<std::pair<std::uint32_t, DctType>> gDcts;
+
+    // the published snapshot, read lock-free, its owner, and the one
+    // retired (see 'publish')
+    std::atomic<SnapType const *>   snapP {};
+    std::shared_ptr<SnapType const> snapC ;
+    std::shared_ptr<SnapType const> snapR ;
+
+    /* 'block' calls that changed lines, and their exclusion of 'snapshot' */
+    IdxType            blks {};
+    mutable std::mutex blkM;
+
+    /* fields of 'field', the latest first */
+    mutable std::list<std::shared_ptr<FieldType const>> flds;
+    mutable std::mutex                                  fldM;
     
 public:
 
     static IdxType constexpr DICHI { 7 };
+
+    /* fields kept by 'field' */
+    static IdxType constexpr FLD { 16 };
+
+    /* thread count and block size (cells, or global lines) of the passes */
+    static ThreadCntType constexpr NTD {  4 };
+    static IdxType       constexpr BLK { 32 };
 };
 
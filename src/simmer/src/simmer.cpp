@@ -29,12 +29,18 @@
 Simmer::Simmer(Geometry                               & geometry,
                Router                                 & router  ,
                std::vector<std::unique_ptr<Actuator>> & actrs   ,
-               ThreadCntType                            ntd     )
+               ThreadCntType                            ntd     ,
+               CrdType                                  hrz     ,
+               CrdType                                  cng     ,
+               HookType                                 hook    )
 
     : geometry { geometry },
       router   { router   },
       actrs    { actrs    },
-      ntd      { ntd      }
+      ntd      { ntd      },
+      hrz      { hrz      },
+      hook     { hook     },
+      cng      { cng      }
 {
     for (IdxType i {}; i < actrs.size(); i++)
         iQue.push(i);
@@ -48,7 +54,11 @@ Simmer::Simmer(Geometry                               & geometry,
     }
 
     oVue.reserve(actrs.size());
+
+    if (cng > 0)
+        ocpz.resize(geometry.getNosoz().size());
     
+    adapt    ();
     intervene();
 
     // /* single-threaded */
@@ -77,15 +87,112 @@ Simmer::Simmer(Geometry                               & geometry,
     barry.arrive_and_wait();                                    // parity shift
     do
     {
+        stps++;
+
         std::swap(iQue, oQue);
         std::swap(iVue, oVue);
-        oVue.clear();
 
-        barry.arrive_and_wait();
+        /* keeps the cells, and the room of their views, for the next step */
+        for (auto & [c, v] : oVue)
+            v.clear();
+
+        adapt    ();
+        reroute  ();
         intervene();
+
+        barry.arrive_and_wait();
         barry.arrive_and_wait();                                // parity shift
         
-    } while (!oQue.empty());
+    } while ((!oQue.empty()) and (not stalled()));
     pooler.shutdown();
+
+    /* the router goes back to its own routes */
+    if (cng > 0)
+    {
+        if (bld.valid())
+            bld.wait();
+
+        router.publish({});
+        router.reclaim();
+    }
+}
+
+
+void
+Simmer::adapt() noexcept
+{
+    if (not (hrz > 0))
+        return;
+
+    auto const actv { std::max(iQue.size(), std::size_t { 1 }) };
+
+    for (auto & actor : actrs)
+        actor->setHorizon(hrz * static_cast<CrdType>(actrs.size()) / static_cast<CrdType>(actv));
+}
+
+
+// between steps, with the workers held at the barrier, as in 'reroute'
+void
+Simmer::intervene()
+{
+    due = hook and hook(stps);
+}
+
+
+// no agent moved in the last step: those queued all stayed put, cut off
+// from the exits, and no hook is due to reopen a line for them
+bool
+Simmer::stalled() const noexcept
+{
+    if (due or (not router.reroutes()))
+        return false;
+
+    auto const strd
+    {
+        std::count_if(actrs.cbegin(), actrs.cend(), [] (auto const & a) { return a->isStranded(); })
+    };
+
+    return static_cast<std::size_t>(strd) == oQue.size();
 }
 
+
+// between steps, with the workers held at the barrier (so that no query
+// runs): the snapshot retired a step ago is released, the one formed in
+// the background is published if done, and every 'PRD' steps the next is
+// set off, off the mean occupancy of the cells since; the steps never
+// wait on a snapshot
+void
+Simmer::reroute()
+{
+    if (not (cng > 0))
+        return;
+
+    router.reclaim();
+
+    /* agents out (in dummy cells) crowd no route */
+    for (auto const & actor : actrs)
+        if (auto const cIdx { actor->getWhere().first }; not geometry.isDummy(cIdx))
+            ocpz[cIdx]++;
+
+    stp++;
+
+    if (bld.valid() and (bld.wait_for(std::chrono::seconds::zero()) == std::future_status::ready))
+        router.publish(bld.get());
+
+    if (bld.valid() or (stp < PRD))
+        return;
+
+    std::vector<CrdType> pnlz;
+    pnlz.reserve(ocpz.size());
+
+    for (auto & o : ocpz)
+    {
+        pnlz.push_back(cng * o / static_cast<CrdType>(stp));
+        o = 0;
+    }
+
+    stp = 0;
+
+    bld = std::async(std::launch::async,
+                     [this, pnlz = std::move(pnlz)] { return router.snapshot(pnlz); });
+}
@@ -25,6 +25,9 @@
 
 #pragma once
 
+#include <future>
+#include <functional>
+
 #include "spawner.hpp"
 #include "actuator.hpp"
 
@@ -40,10 +43,23 @@ public:
              Simmer() = delete;
     virtual ~Simmer() = default;
 
+    // called between steps with the count of steps done, while no agent
+    // moves, so that it may eg. block lines of the router (see 'Router::
+    // block'); it returns whether it is still due to intervene later
+    using HookType = std::function<bool (IdxType)>;
+
+    // 'hrz' bounds the look-ahead of the agents, in steps (0: unbounded);
+    // it grows in proportion as agents leave; 'cng' (a length per agent
+    // in a cell) routes the agents around crowds (0: off), off snapshots
+    // of the router formed in the background (see 'reroute'); 'hook' is
+    // called before the first step and after each one
     Simmer(Geometry                               & geometry      ,
 	       Router                                 & router        ,
 	       std::vector<std::unique_ptr<Actuator>> & actrs         ,
-           ThreadCntType                            ntd      = NTD);
+           ThreadCntType                            ntd      = NTD,
+           CrdType                                  hrz      = 0  ,
+           CrdType                                  cng      = 0  ,
+           HookType                                 hook     = {} );
 
 protected:
 
@@ -54,14 +70,44 @@ protected:
     
     ThreadCntType const ntd;
 
+    /* look-ahead horizon, in steps */
+    CrdType const hrz;
+
     std::queue<IdxType> iQue, oQue;
     ViewType            iVue, oVue;
     std::mutex          queM, vueM;
 
     /* meta-processing between time steps */
-    virtual void intervene() {};
+    HookType const hook;
+
+    /* steps done, and whether 'hook' is due to intervene later */
+    IdxType stps {};
+    bool    due  {};
+
+    void intervene();
+
+    /* every agent left is cut off from the exits, and none will be let out */
+    bool stalled() const noexcept;
+
+    /* scales the horizon of the agents to those still active */
+    void adapt() noexcept;
+
+    /* congestion cost, per agent */
+    CrdType const cng;
+
+    // agents per cell, summed over the steps since the last snapshot was
+    // set off ('stp'), and the snapshot being formed
+    std::vector<CrdType>                                 ocpz   ;
+    IdxType                                              stp  {};
+    std::future<std::shared_ptr<Router::SnapType const>> bld    ;
+
+    /* publishes the snapshot formed, if done, and sets off the next */
+    void reroute();
 
 public:
 
     static ThreadCntType constexpr NTD { 4 };
+
+    /* steps between the snapshots set off */
+    static IdxType constexpr PRD { 25 };
 };
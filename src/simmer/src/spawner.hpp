@@ -125,6 +125,36 @@ Spawner::spawn(std::queue<IdxType> & que, F && func, Tn && ... args)
 }
 
 
+/*
+ * calls func(bgn, end) over blocks [bgn, end) of 'blk' indices of
+ * [0, size), on up to 'ntd' threads; inline if a thread would do
+ */
+template <typename F>
+void
+spawnBlocks(ThreadCntType ntd, IdxType size, IdxType blk, F && func)
+{
+    auto const bSize { (size + blk - 1) / blk };
+
+    if ((ntd < 2) or (bSize < 2))
+    {
+        for (IdxType b {}; b < bSize; b++)
+            func(b * blk, std::min((b + 1) * blk, size));
+
+        return;
+    }
+
+    std::queue<IdxType> que;
+    for (IdxType b {}; b < bSize; b++)
+        que.push(b);
+
+    Spawner { static_cast<ThreadCntType>(std::min<IdxType>(ntd, bSize)) }.spawn<CallPattern::FNIDX>(que,
+        [size, blk, & func] (IdxType b)
+        {
+            func(b * blk, std::min((b + 1) * blk, size));
+        });
+}
+
+
 template<typename B>
 class Pooler
 {
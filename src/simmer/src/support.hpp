@@ -93,18 +93,18 @@ inline CrdType
 vctrAngle(smr::Point const & k, smr::Point const & l) noexcept
 {
     /* vector norms */
-    CrdType kn { std::sqrt(std::pow(k.x, 2) + std::pow(k.y, 2)) };
-    CrdType ln { std::sqrt(std::pow(l.x, 2) + std::pow(l.y, 2)) };
+    CrdType kn { std::sqrt(k.x * k.x + k.y * k.y) };
+    CrdType ln { std::sqrt(l.x * l.x + l.y * l.y) };
 
-    auto const Pi  { std::numbers::pi };
+    auto const Pi  { std::numbers::pi_v<CrdType> };
 
     auto const a { std::asin(((k.x * l.y) - (k.y * l.x)) / (kn * ln)) };
-    auto const s { fELess(0., (k.x * l.x) + (k.y * l.y))              };
+    auto const s { fELess(CrdType {}, (k.x * l.x) + (k.y * l.y))      };
 
     if (s)
         return a;
 
-    if (fELess(0., a))
+    if (fELess(CrdType {}, a))
         return (Pi - a);
     else
         return -(Pi + a);
@@ -25,17 +25,31 @@
 
 #pragma once
 
+#include <concepts>
 #include <cstdint>
 #include <cmath>
 #include <limits>
 
 
+// the narrow variants (see the USE_CRD32 and USE_IDX32 build options)
+// halve the footprint of the tables, for geometries that fit them
+#ifdef SIMMER_CRD32
+using CrdType = float;
+#else
 using CrdType = double;
+#endif
+
 using LCType  = std::uint8_t;
+
+#ifdef SIMMER_IDX32
+using IdxType = std::uint32_t;
+#else
 using IdxType = std::uint64_t;
+#endif
 
 
 auto constexpr IdxTypeMax { std::numeric_limits<IdxType>::max() };
+auto constexpr CrdTypeMax { std::numeric_limits<CrdType>::max() };
 
 
 /* 'subsolid' := { LineColor < SOLD } */
@@ -112,3 +126,28 @@ fELess(T x, T y, std::uint32_t ulp = 2) noexcept
     return fLess(x, y, ulp) or fEqual(x, y, ulp);
 }
 
+
+/* mixed operands (eg. double literals, with float coordinates) compare as CrdType */
+template <std::floating_point T, std::floating_point U> requires (not std::same_as<T, U>)
+inline bool
+fEqual(T x, U y, std::uint32_t ulp = 2) noexcept
+{
+    return fEqual(static_cast<CrdType>(x), static_cast<CrdType>(y), ulp);
+}
+
+
+template <std::floating_point T, std::floating_point U> requires (not std::same_as<T, U>)
+inline bool
+fLess(T x, U y, std::uint32_t ulp = 2) noexcept
+{
+    return fLess(static_cast<CrdType>(x), static_cast<CrdType>(y), ulp);
+}
+
+
+template <std::floating_point T, std::floating_point U> requires (not std::same_as<T, U>)
+inline bool
+fELess(T x, U y, std::uint32_t ulp = 2) noexcept
+{
+    return fELess(static_cast<CrdType>(x), static_cast<CrdType>(y), ulp);
+}
+
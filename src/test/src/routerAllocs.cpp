@@ -0,0 +1,232 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+
+#include "partition.hpp"
+#include "parser.hpp"
+#include "mesher.hpp"
+#include "finder.hpp"
+#include "router.hpp"
+#include "actuator.hpp"
+
+
+/*
+ * checks that the query path of the router does not allocate once its
+ * scratch buffers are warm: the global 'operator new' is replaced by one
+ * that counts, and the count is taken over a second pass of the queries;
+ * so for the steps of the agents, past the history each of them records
+ */
+
+std::atomic<bool>        counting {};
+std::atomic<std::size_t> allocs   {};
+
+
+void *
+operator new(std::size_t n)
+{
+    if (counting)
+        allocs++;
+
+    if (auto const p { std::malloc(n ? n : 1) })
+        return p;
+
+    throw std::bad_alloc {};
+}
+
+void
+operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+/* the queries of 'Actuator::move', at the midpoints of the nonsolid lines */
+void
+query(Router const & router, Router::ScratchType & scr, std::vector<DuoType> const & pts, std::vector<smr::Point> const & pos)
+{
+    for (IdxType i {}; i < pts.size(); i++)
+    {
+        auto const cIdx { pts[i].cIdx };
+        auto const pt   { pos[i]      };
+
+        router.findLine(scr, cIdx, pt);
+
+        for (auto const rch : { CrdTypeMax, CrdType { 1 } })
+        {
+            auto navi { router.findVisible(scr, cIdx, pt, std::nullopt, IdxTypeMax, rch) };
+
+            auto const trgt { std::get<1>(* navi).back() };
+
+            router.findCell(std::get<0>(* navi), std::get<1>(* navi), .5);
+
+            /* revalidation of the target found */
+            navi = router.findVisible(scr, cIdx, pt, trgt, IdxTypeMax, rch);
+
+            if (navi)
+                router.findCell(std::get<0>(* navi), std::get<1>(* navi), .5);
+        }
+    }
+}
+
+
+/* the nodes of an agent's history: one per cell entered, and one per position */
+std::size_t
+history(Actuator const & actor)
+{
+    std::size_t n {};
+
+    for (auto const & [cIdx, pts] : actor.getPath())
+        n += 1 + pts.size();
+
+    return n;
+}
+
+
+/* a step of the agents still out, as 'Simmer' takes it; counts the history grown */
+std::size_t
+step(std::vector<std::unique_ptr<Actuator>> & actrs, std::vector<IdxType> & actv, ViewType & iVue, ViewType & oVue)
+{
+    std::mutex  queM, vueM;
+    std::size_t grwn {};
+
+    std::vector<IdxType> next;
+
+    for (auto const idx : actv)
+    {
+        std::queue<IdxType> que;
+
+        auto const hist { history(* actrs[idx]) };
+
+        counting = true;
+        (* actrs[idx])(que, queM, iVue, oVue, vueM);
+        counting = false;
+
+        grwn += history(* actrs[idx]) - hist;
+
+        if (not que.empty())
+            next.push_back(idx);
+    }
+
+    actv = std::move(next);
+
+    std::swap(iVue, oVue);
+    for (auto & [cIdx, v] : oVue)
+        v.clear();
+
+    return grwn;
+}
+
+
+int main(int argc, char ** argv)
+{
+    if (argc != 2)
+    {
+        std::cout << "Expected a geometry file" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::path const geomPath { argv[1] };
+
+    Mesher    mesher    { 2                             };
+    Geometry  geometry  { mesher, true, false, true     };
+    Partition partition {                               };
+    Parser    parser    { geomPath, geometry, partition };
+
+    if (auto const err { parser.parse() })
+    {
+        std::cout << err.value() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (auto const err { geometry.finalize() })
+    {
+        std::cout << err.value() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Finder finder { geometry, 2, 4 };
+    Router router { geometry, finder, geometry.releaseMCSs() };
+
+    std::vector<DuoType>    pts;
+    std::vector<smr::Point> pos;
+
+    auto const & nosoz { geometry.getNosoz() };
+
+    for (IdxType cIdx {}; cIdx < nosoz.size(); cIdx++)
+    {
+        if (geometry.isDummy(cIdx))
+            continue;
+
+        for (IdxType sIdx {}; sIdx < nosoz[cIdx].size(); sIdx++)
+        {
+            auto const pt { linePoint(nosoz[cIdx][sIdx]) };
+
+            if (geometry.isInsideCellX(pt, cIdx, .3))
+            {
+                pts.push_back({ cIdx, sIdx });
+                pos.push_back(pt);
+            }
+        }
+    }
+
+    Router::ScratchType scr;
+
+    /* warms the buffers */
+    query(router, scr, pts, pos);
+
+    counting = true;
+
+    for (int i {}; i < 3; i++)
+        query(router, scr, pts, pos);
+
+    counting = false;
+
+    std::cout << allocs << " allocations over " << 3 * pts.size() << " query points" << std::endl;
+
+    if ((not pts.size()) or allocs)
+        return EXIT_FAILURE;
+
+    /* the agents, one at each query point, with room in the views of every cell */
+    std::vector<std::unique_ptr<Actuator>> actrs;
+    std::vector<IdxType>                   actv;
+
+    for (IdxType i {}; i < pts.size(); i++)
+    {
+        actrs.push_back(std::make_unique<Actuator>(i, pts[i].cIdx, pos[i], geometry, router));
+        actv.push_back(i);
+    }
+
+    ViewType iVue, oVue;
+
+    for (IdxType cIdx {}; cIdx < nosoz.size(); cIdx++)
+    {
+        iVue[cIdx].reserve(actrs.size());
+        oVue[cIdx].reserve(actrs.size());
+    }
+
+    /* warms the buffers */
+    for (int i {}; i < 3; i++)
+        step(actrs, actv, iVue, oVue);
+
+    allocs = 0;
+
+    std::size_t grwn {}, stps {};
+
+    for (int i {}; i < 10; i++)
+    {
+        stps += actv.size();
+        grwn += step(actrs, actv, iVue, oVue);
+    }
+
+    std::cout << allocs << " allocations over " << stps << " agent steps, " << grwn << " of them history" << std::endl;
+
+    return (stps and (allocs == grwn)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,141 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "partition.hpp"
+#include "parser.hpp"
+#include "mesher.hpp"
+#include "finder.hpp"
+#include "router.hpp"
+
+
+/*
+ * checks that a snapshot of the router formed after 'block' routes no
+ * agent through a closed door, and that one formed before it is not
+ * published; nor does a field of the exits asked for after it, nor
+ * does a distance pass it; each door of the geometry is closed in turn
+ */
+
+int main(int argc, char ** argv)
+{
+    if (argc != 2)
+    {
+        std::cout << "Expected a geometry file" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::path const geomPath { argv[1] };
+
+    Mesher    mesher    { 2                             };
+    Geometry  geometry  { mesher, true, false, true     };
+    Partition partition {                               };
+    Parser    parser    { geomPath, geometry, partition };
+
+    if (auto const err { parser.parse() })
+    {
+        std::cout << err.value() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (auto const err { geometry.finalize() })
+    {
+        std::cout << err.value() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Finder finder { geometry, 2, 4 };
+    Router router { geometry, finder, geometry.releaseMCSs() };
+
+    auto const & susoMaps { geometry.getSusoMaps() };
+
+    std::vector<CrdType> const pnlz(susoMaps.size());
+
+    std::vector<DuoType> exits;
+
+    auto const & nosoz { geometry.getNosoz() };
+    for (IdxType c {}; c < nosoz.size(); c++)
+        for (IdxType s {}; s < nosoz[c].size(); s++)
+            if (geometry.isExit(c, s))
+                exits.push_back({ c, s });
+
+    IdxType doors {};
+    IdxType fails {};
+
+    for (IdxType c {}; c < susoMaps.size(); c++)
+        for (auto const & [s, trio] : susoMaps[c])
+        {
+            /* each door once; an EXIT is owned by its only cell */
+            if (trio.cIdx <= c)
+                continue;
+
+            std::array<DuoType, 2> const door { DuoType { c, s }, DuoType { trio.cIdx, trio.oIdx } };
+
+            doors++;
+
+            /* formed before the door closes */
+            auto const stale  { router.snapshot(pnlz) };
+            auto const staleF { router.field(exits)   };
+
+            if (auto const err { router.block({ door.begin(), 1 }) })
+            {
+                std::cout << err.value() << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            auto rts { router.reroutes() };
+
+            router.publish(stale);
+
+            if (router.reroutes() != rts)
+            {
+                std::cout << "door " << s << " of cell " << c << ": a stale snapshot was published" << std::endl;
+                fails++;
+            }
+
+            router.publish(router.snapshot(pnlz));
+
+            /* either side of the closed door is routed within its own cell */
+            for (auto const & line : door)
+                if (router.next(line.cIdx, line.sIdx).cIdx != line.cIdx)
+                {
+                    std::cout << "door " << s << " of cell " << c << ": routed through from cell "
+                              << line.cIdx << std::endl;
+                    fails++;
+                }
+
+            router.publish({});
+            router.reclaim();
+
+            auto const fld { router.field(exits) };
+
+            if (fld == staleF)
+            {
+                std::cout << "door " << s << " of cell " << c << ": a stale field was kept" << std::endl;
+                fails++;
+            }
+
+            for (auto const & line : door)
+                if (router.next(* fld, line.cIdx, line.sIdx).cIdx != line.cIdx)
+                {
+                    std::cout << "door " << s << " of cell " << c << ": the field routes through from cell "
+                              << line.cIdx << std::endl;
+                    fails++;
+                }
+
+            /* a closed door is cut off */
+            if (not std::isinf(router.distance(door[0], exits.front())))
+            {
+                std::cout << "door " << s << " of cell " << c << ": a distance passes it" << std::endl;
+                fails++;
+            }
+
+            if (auto const err { router.block({ door.begin(), 1 }, false) })
+            {
+                std::cout << err.value() << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+    std::cout << fails << " failures over " << doors << " doors" << std::endl;
+
+    return (doors and (not fails)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}